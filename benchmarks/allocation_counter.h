@@ -0,0 +1,65 @@
+#pragma once
+
+// Заменяет глобальный operator new счётчиком выделений и их объёма. Подключается ровно
+// в одну единицу трансляции программы
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+
+inline std::atomic<size_t> allocations_count = 0;
+inline std::atomic<size_t> allocated_bytes = 0;
+
+struct AllocationStats {
+    size_t count = 0;
+    size_t bytes = 0;
+};
+
+// Выделения памяти за время вызова function
+template <typename Function>
+AllocationStats CountAllocations(Function function) {
+    const size_t count_before = allocations_count;
+    const size_t bytes_before = allocated_bytes;
+    function();
+    return {allocations_count - count_before, allocated_bytes - bytes_before};
+}
+
+}  // namespace bench
+
+void* operator new(size_t size) {
+    ++bench::allocations_count;
+    bench::allocated_bytes += size;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+// Через эти перегрузки выделяет память std::pmr::new_delete_resource, ресурс по умолчанию
+void* operator new(size_t size, std::align_val_t alignment) {
+    ++bench::allocations_count;
+    bench::allocated_bytes += size;
+    const size_t align = static_cast<size_t>(alignment);
+    if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
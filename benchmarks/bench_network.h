@@ -0,0 +1,125 @@
+#pragma once
+
+// Общее для бенчмарков справочника и маршрутизации: синтетическая сеть
+
+#include "bench_timing.h"
+#include "transport_catalogue.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+struct NetworkParams {
+    int stops = 100000;
+    int buses = 10000;
+    int stops_per_bus = 20;
+};
+
+// Параметры из командной строки: [stops] [buses] [stops_per_bus], начиная с first_arg.
+// Не заданные в командной строке берутся из params
+inline NetworkParams ParseNetworkParams(int argc, char* argv[], int first_arg = 1, NetworkParams params = {}) {
+    int* fields[] = {&params.stops, &params.buses, &params.stops_per_bus};
+    for (int i = 0; i < 3 && first_arg + i < argc; ++i) {
+        *fields[i] = std::atoi(argv[first_arg + i]);
+    }
+    return params;
+}
+
+// Данные для AddBulk вместе с названиями, на которые они ссылаются.
+// Перемещать можно, копировать нельзя: копия data ссылалась бы на чужие названия
+struct Network {
+    Network() = default;
+    Network(const Network&) = delete;
+    Network(Network&&) = default;
+
+    std::vector<std::string> stop_titles;
+    std::vector<std::string> bus_titles;
+    transport_catalogue::TransportCatalogue::BulkData data;
+};
+
+/*
+ * Остановки стоят в узлах квадратной сетки. Каждый маршрут — случайное блуждание
+ * по соседним узлам, половина маршрутов кольцевые. Расстояния между соседними
+ * остановками случайные, от 150 до 900 м в каждую сторону
+ */
+inline Network MakeNetwork(const NetworkParams& params, std::mt19937& random) {
+    const int side = static_cast<int>(std::sqrt(params.stops)) + 1;
+    Network network;
+    std::vector<std::string>& stop_titles = network.stop_titles;
+    std::vector<std::string>& bus_titles = network.bus_titles;
+    transport_catalogue::TransportCatalogue::BulkData& data = network.data;
+    stop_titles.resize(params.stops);
+    bus_titles.resize(params.buses);
+
+    for (int i = 0; i < params.stops; ++i) {
+        stop_titles[i] = "Stop " + std::to_string(i);
+        data.stops.push_back({stop_titles[i], {55 + (i / side) * 0.002, 37 + (i % side) * 0.003}});
+    }
+
+    for (int bus = 0; bus < params.buses; ++bus) {
+        bus_titles[bus] = "Bus " + std::to_string(bus);
+        int current = static_cast<int>(random() % params.stops);
+        std::vector<int> route{current};
+        for (int k = 1; k < params.stops_per_bus; ++k) {
+            const int x = current % side;
+            const int y = current / side;
+            int next_x;
+            int next_y;
+            do {
+                const int direction = static_cast<int>(random() % 4);
+                next_x = x + (direction == 0) - (direction == 1);
+                next_y = y + (direction == 2) - (direction == 3);
+            } while (next_x < 0 || next_y < 0 || next_x >= side || next_y * side + next_x >= params.stops);
+            current = next_y * side + next_x;
+            route.push_back(current);
+        }
+
+        const bool is_roundtrip = random() % 2;
+        if (is_roundtrip) {
+            route.push_back(route.front());
+        }
+        for (size_t k = 0; k + 1 < route.size(); ++k) {
+            data.distances.push_back({stop_titles[route[k]], stop_titles[route[k + 1]],
+                                      static_cast<int>(150 + random() % 750)});
+            data.distances.push_back({stop_titles[route[k + 1]], stop_titles[route[k]],
+                                      static_cast<int>(150 + random() % 750)});
+        }
+
+        // Справочник хранит некольцевой маршрут целиком, до конечной и обратно
+        std::vector<std::string_view> stops;
+        for (int stop : route) {
+            stops.push_back(stop_titles[stop]);
+        }
+        if (!is_roundtrip) {
+            for (int k = static_cast<int>(route.size()) - 2; k >= 0; --k) {
+                stops.push_back(stop_titles[route[k]]);
+            }
+        }
+        data.buses.push_back({bus_titles[bus], std::move(stops), is_roundtrip});
+    }
+    return network;
+}
+
+inline void FillNetwork(transport_catalogue::TransportCatalogue& catalogue, const NetworkParams& params,
+                        std::mt19937& random) {
+    catalogue.AddBulk(MakeNetwork(params, random).data, 1);
+}
+
+// Остановки, через которые проходит хотя бы один маршрут
+inline std::vector<transport_catalogue::StopId> GetServedStops(
+        const transport_catalogue::TransportCatalogue& catalogue) {
+    std::vector<transport_catalogue::StopId> served;
+    for (transport_catalogue::StopId stop = 0; stop < catalogue.GetStopsCount(); ++stop) {
+        if (!catalogue.GetBusesOfStop(stop).empty()) {
+            served.push_back(stop);
+        }
+    }
+    return served;
+}
+
+}  // namespace bench
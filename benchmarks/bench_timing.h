@@ -0,0 +1,47 @@
+#pragma once
+
+// Замер времени и статистика задержек для бенчмарков
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double GetMilliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Лучшее время из repeats запусков function в миллисекундах. На загруженной
+// машине минимум устойчивее среднего
+template <typename Function>
+double MeasureBest(int repeats, Function function) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < repeats; ++i) {
+        const auto start = Clock::now();
+        function();
+        best = std::min(best, GetMilliseconds(start));
+    }
+    return best;
+}
+
+// Выводит среднее и перцентили задержек в микросекундах
+inline void PrintLatency(const char* name, std::vector<double> latencies_us) {
+    if (latencies_us.empty()) {
+        return;
+    }
+    std::sort(latencies_us.begin(), latencies_us.end());
+    double sum = 0;
+    for (double latency : latencies_us) {
+        sum += latency;
+    }
+    const size_t size = latencies_us.size();
+    std::printf("%s: %zu queries, mean %.1f us, p50 %.1f us, p90 %.1f us, p99 %.1f us\n", name, size, sum / size,
+                latencies_us[size / 2], latencies_us[size * 9 / 10], latencies_us[size * 99 / 100]);
+}
+
+}  // namespace bench
@@ -0,0 +1,105 @@
+// Время загрузки справочника: последовательные AddStop, SetStopsDistance и AddBus
+// против AddBulk в 1, 2, 4 и 8 потоках и в потоках по числу ядер. Проверяет, что
+// после AddBulk справочник совпадает с загруженным последовательно.
+// Запуск: bulk_load_bench [stops] [buses] [stops_per_bus] [repeats]
+
+#include "bench_network.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <thread>
+
+using namespace transport_catalogue;
+
+namespace {
+
+bool IsSameStats(const BusStats& lhs, const BusStats& rhs) {
+    return lhs.stops_amount == rhs.stops_amount && lhs.uniq_stops_amount == rhs.uniq_stops_amount
+           && lhs.route_length == rhs.route_length && lhs.geo_length == rhs.geo_length
+           && lhs.curvature == rhs.curvature;
+}
+
+// Сравнивает остановки, расстояния по маршрутам, маршруты остановок и статистику маршрутов
+size_t CountDifferences(const TransportCatalogue& expected, const TransportCatalogue& actual,
+                        const TransportCatalogue::BulkData& data) {
+    if (expected.GetStopsCount() != actual.GetStopsCount() || expected.GetBusesCount() != actual.GetBusesCount()) {
+        return 1;
+    }
+    size_t differences = 0;
+    for (StopId id = 0; id < expected.GetStopsCount(); ++id) {
+        const Stop stop = expected.GetStop(id);
+        differences += actual.FindStop(stop.title) != id;
+        const std::span<const BusId> expected_buses = expected.GetBusesOfStop(id);
+        const std::span<const BusId> actual_buses = actual.GetBusesOfStop(id);
+        differences += !std::equal(expected_buses.begin(), expected_buses.end(), actual_buses.begin(),
+                                   actual_buses.end());
+    }
+    for (const TransportCatalogue::DistanceData& distance : data.distances) {
+        differences += expected.GetDistance(distance.from, distance.to) != actual.GetDistance(distance.from, distance.to);
+    }
+    for (BusId id = 0; id < expected.GetBusesCount(); ++id) {
+        differences += actual.FindBus(expected.GetBus(id).title) != id;
+        differences += !IsSameStats(expected.GetBusStats(id), actual.GetBusStats(id));
+    }
+    return differences;
+}
+
+struct LoadResult {
+    std::unique_ptr<TransportCatalogue> catalogue;
+    double ms = std::numeric_limits<double>::infinity();
+};
+
+// Лучшее время загрузки в пустой справочник. Освобождение прежнего справочника в замер не входит
+template <typename Load>
+LoadResult MeasureLoad(int repeats, Load load) {
+    LoadResult result;
+    for (int i = 0; i < repeats; ++i) {
+        result.catalogue.reset();
+        auto catalogue = std::make_unique<TransportCatalogue>();
+        const auto start = bench::Clock::now();
+        load(*catalogue);
+        result.ms = std::min(result.ms, bench::GetMilliseconds(start));
+        result.catalogue = std::move(catalogue);
+    }
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const bench::NetworkParams params = bench::ParseNetworkParams(argc, argv, 1, {200000, 20000, 40});
+    const int repeats = argc > 4 ? std::atoi(argv[4]) : 3;
+
+    std::mt19937 random(3);
+    const bench::Network network = bench::MakeNetwork(params, random);
+    const TransportCatalogue::BulkData& data = network.data;
+    std::printf("%zu stops, %zu distances, %zu buses\n", data.stops.size(), data.distances.size(),
+                data.buses.size());
+
+    const LoadResult serial = MeasureLoad(repeats, [&](TransportCatalogue& catalogue) {
+        for (const TransportCatalogue::StopData& stop : data.stops) {
+            catalogue.AddStop(stop.title, stop.coords);
+        }
+        for (const TransportCatalogue::DistanceData& distance : data.distances) {
+            catalogue.SetStopsDistance(distance.from, distance.to, distance.distance);
+        }
+        for (const TransportCatalogue::BusData& bus : data.buses) {
+            catalogue.AddBus(bus.title, bus.stops, bus.is_roundtrip);
+        }
+    });
+    std::printf("AddStop, SetStopsDistance, AddBus: %.0f ms\n", serial.ms);
+
+    size_t differences = 0;
+    for (const unsigned threads : {1u, 2u, 4u, 8u, std::max(1u, std::thread::hardware_concurrency())}) {
+        const LoadResult bulk = MeasureLoad(repeats, [&](TransportCatalogue& catalogue) {
+            catalogue.AddBulk(data, threads);
+        });
+        const size_t threads_differences = CountDifferences(*serial.catalogue, *bulk.catalogue, data);
+        std::printf("AddBulk, %u threads: %.0f ms, %.2fx, %zu differences\n", threads, bulk.ms, serial.ms / bulk.ms,
+                    threads_differences);
+        differences += threads_differences;
+    }
+
+    return differences == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,79 @@
+// Сравнение FindRoute по иерархии сжатия с обычным поиском Дейкстры на синтетической
+// сети: время и память построения иерархии, задержки обоих поисков и совпадение ответов.
+// Запуск: contraction_bench [stops] [buses] [stops_per_bus] [queries]
+
+#include "bench_network.h"
+#include "transport_router.h"
+
+#include <malloc.h>
+
+using namespace transport_catalogue;
+
+namespace {
+
+// Занятая память кучи, включая крупные блоки, выделенные через mmap
+size_t GetHeapBytes() {
+    const struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const bench::NetworkParams params = bench::ParseNetworkParams(argc, argv);
+    const int queries_count = argc > 4 ? std::atoi(argv[4]) : 2000;
+
+    std::mt19937 random(3);
+    TransportCatalogue catalogue;
+    bench::FillNetwork(catalogue, params, random);
+
+    TransportRouter router(catalogue, {6, 40});
+    std::printf("%d stops, %d buses, %d stops per bus: %zu edges\n", params.stops, params.buses,
+                params.stops_per_bus, router.GetEdgeCount());
+
+    const std::vector<StopId> served = bench::GetServedStops(catalogue);
+    std::vector<std::pair<StopId, StopId>> queries(queries_count);
+    for (auto& [from, to] : queries) {
+        from = served[random() % served.size()];
+        to = served[random() % served.size()];
+    }
+
+    // Один и тот же набор запросов до и после Contract
+    auto run_queries = [&](const char* name, std::vector<double>& times) {
+        TransportRouter::Workspace workspace(router);
+        std::vector<double> latencies;
+        latencies.reserve(queries.size());
+        times.clear();
+        for (const auto& [from, to] : queries) {
+            const auto start = bench::Clock::now();
+            const std::optional<TransportRouter::Route> route = router.FindRoute(from, to, workspace);
+            latencies.push_back(bench::GetMilliseconds(start) * 1000);
+            times.push_back(route ? route->total_time : -1);
+        }
+        bench::PrintLatency(name, std::move(latencies));
+    };
+
+    std::vector<double> plain_times;
+    run_queries("plain FindRoute", plain_times);
+
+    const size_t heap_before = GetHeapBytes();
+    const auto contract_start = bench::Clock::now();
+    router.Contract();
+    const double contract_ms = bench::GetMilliseconds(contract_start);
+    std::printf("Contract: %.0f ms, +%.1f MiB\n", contract_ms,
+                (static_cast<double>(GetHeapBytes()) - static_cast<double>(heap_before)) / (1 << 20));
+
+    std::vector<double> contracted_times;
+    run_queries("contracted FindRoute", contracted_times);
+
+    // Равноценные пути могут отличаться порядком сложения, отсюда допуск
+    size_t mismatches = 0;
+    double max_difference = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const double difference = std::abs(plain_times[i] - contracted_times[i]);
+        max_difference = std::max(max_difference, difference);
+        mismatches += difference > 1e-9 * std::max(1.0, plain_times[i]);
+    }
+    std::printf("%zu mismatching answers, max difference %g\n", mismatches, max_difference);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,103 @@
+// Пропускная способность расчёта географической длины маршрутов. Сравнивает прежний
+// расчёт ComputeDistance по каждому отрезку, ComputeHaversineDistance по каждому отрезку
+// на заранее переведённых точках и пакетный geo::ComputeRouteLength (с AVX2, если
+// процессор его поддерживает). Проверяет, что длины расходятся не больше допустимого.
+// Запуск: geo_kernel_bench [stops] [routes] [stops_per_route] [repeats]
+
+#include "bench_timing.h"
+#include "geo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+
+// Допустимое расхождение ComputeDistance и ComputeHaversineDistance на отрезке, см. geo.h
+constexpr double SEGMENT_TOLERANCE = 0.15;
+// Пакетный расчёт суммирует отрезки в другом порядке, чем последовательный
+constexpr double RELATIVE_TOLERANCE = 1e-12;
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int stops = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int routes_count = argc > 2 ? std::atoi(argv[2]) : 100000;
+    const int stops_per_route = argc > 3 ? std::atoi(argv[3]) : 40;
+    const int repeats = argc > 4 ? std::atoi(argv[4]) : 5;
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> latitude(55.5, 56.0);
+    std::uniform_real_distribution<double> longitude(37.3, 37.9);
+    std::vector<geo::Coordinates> coords(stops);
+    std::vector<geo::SpherePoint> points(stops);
+    for (int i = 0; i < stops; ++i) {
+        coords[i] = {latitude(random), longitude(random)};
+        points[i] = geo::ToSpherePoint(coords[i]);
+    }
+
+    // Маршруты лежат подряд в одном массиве, как остановки маршрутов в справочнике
+    std::vector<uint32_t> route_stops(static_cast<size_t>(routes_count) * stops_per_route);
+    for (uint32_t& stop : route_stops) {
+        stop = random() % stops;
+    }
+    auto get_route = [&](int route) {
+        return std::span<const uint32_t>(route_stops).subspan(static_cast<size_t>(route) * stops_per_route,
+                                                             stops_per_route);
+    };
+    const size_t segments = static_cast<size_t>(routes_count) * std::max(stops_per_route - 1, 0);
+
+    std::vector<double> acos_lengths(routes_count);
+    std::vector<double> haversine_lengths(routes_count);
+    std::vector<double> batch_lengths(routes_count);
+    auto run = [&](const char* name, std::vector<double>& lengths, auto compute) {
+        const double ms = bench::MeasureBest(repeats, [&] {
+            for (int route = 0; route < routes_count; ++route) {
+                lengths[route] = compute(get_route(route));
+            }
+        });
+        std::printf("%s: %.0f ms, %.1f M segments/s\n", name, ms, segments / ms / 1000);
+    };
+
+    std::printf("%d routes of %d stops, %zu segments\n", routes_count, stops_per_route, segments);
+    run("ComputeDistance per segment", acos_lengths, [&](std::span<const uint32_t> route) {
+        double length = 0;
+        for (size_t i = 0; i + 1 < route.size(); ++i) {
+            length += geo::ComputeDistance(coords[route[i]], coords[route[i + 1]]);
+        }
+        return length;
+    });
+    run("ComputeHaversineDistance per segment", haversine_lengths, [&](std::span<const uint32_t> route) {
+        double length = 0;
+        for (size_t i = 0; i + 1 < route.size(); ++i) {
+            length += geo::ComputeHaversineDistance(points[route[i]], points[route[i + 1]]);
+        }
+        return length;
+    });
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    const char* batch_name = __builtin_cpu_supports("avx2") ? "ComputeRouteLength, avx2" : "ComputeRouteLength, scalar";
+#else
+    const char* batch_name = "ComputeRouteLength, scalar";
+#endif
+    run(batch_name, batch_lengths, [&](std::span<const uint32_t> route) {
+        return geo::ComputeRouteLength(points, route);
+    });
+
+    size_t mismatches = 0;
+    double max_difference = 0;
+    for (int route = 0; route < routes_count; ++route) {
+        const double difference = std::abs(batch_lengths[route] - acos_lengths[route]);
+        max_difference = std::max(max_difference, difference);
+        mismatches += difference > SEGMENT_TOLERANCE * (stops_per_route - 1);
+        mismatches += std::abs(batch_lengths[route] - haversine_lengths[route])
+                      > RELATIVE_TOLERANCE * haversine_lengths[route];
+    }
+    std::printf("max difference from ComputeDistance: %.4f m per route\n", max_difference);
+    std::printf("%zu routes out of tolerance\n", mismatches);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,132 @@
+// Размещение дерева JSON в куче и в арене: число выделений памяти, время загрузки
+// и освобождения документа json::Load и дерева, собранного json::Builder.
+// Запуск: json_arena_bench [stops] [buses] [repeats]
+
+#include "allocation_counter.h"
+#include "bench_timing.h"
+#include "json.h"
+#include "json_builder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <string>
+
+namespace {
+
+// base_requests с остановками, расстояниями и маршрутами, как во входных данных
+std::string MakeDocument(int stops, int buses, std::mt19937& random) {
+    std::string document = R"({"base_requests": [)";
+    char buffer[96];
+    for (int stop = 0; stop < stops; ++stop) {
+        std::snprintf(buffer, sizeof(buffer), R"(%s{"type": "Stop", "name": "Stop %d", "latitude": %.6f, )",
+                      stop == 0 ? "" : ", ", stop, 55.5 + random() % 500000 / 1e6);
+        document += buffer;
+        std::snprintf(buffer, sizeof(buffer), R"("longitude": %.6f, "road_distances": {)",
+                      37.3 + random() % 600000 / 1e6);
+        document += buffer;
+        for (int i = 0; i < std::min(3, stops - 1); ++i) {
+            std::snprintf(buffer, sizeof(buffer), R"(%s"Stop %u": %u)", i == 0 ? "" : ", ",
+                          static_cast<unsigned>((stop + 1 + i) % stops), static_cast<unsigned>(100 + random() % 5000));
+            document += buffer;
+        }
+        document += "}}";
+    }
+    for (int bus = 0; bus < buses; ++bus) {
+        document += R"(, {"type": "Bus", "name": "Bus )" + std::to_string(bus) + R"(", "stops": [)";
+        for (int i = 0; i < 20; ++i) {
+            document += std::string(i == 0 ? "" : ", ") + "\"Stop " + std::to_string(random() % stops) + "\"";
+        }
+        document += random() % 2 ? R"(], "is_roundtrip": true})" : R"(], "is_roundtrip": false})";
+    }
+    document += "]}";
+    return document;
+}
+
+// Ответ на запросы Stop: словарь с идентификатором и списком маршрутов на каждую остановку
+json::Node BuildResponses(int stops, std::pmr::memory_resource* resource) {
+    json::Builder builder(resource);
+    json::Builder::ArrayRef responses = builder.StartArray();
+    for (int stop = 0; stop < stops; ++stop) {
+        json::Builder::ArrayRef buses = responses.StartDict()
+                .Key("request_id").Value(stop)
+                .Key("buses").StartArray();
+        for (int bus = 0; bus < 5; ++bus) {
+            buses.Value(std::string("Bus ").append(std::to_string(stop % 1000 + bus)));
+        }
+        buses.EndArray().EndDict();
+    }
+    return responses.EndArray().Build();
+}
+
+struct Result {
+    bench::AllocationStats allocations;
+    double build_ms = 0;
+    double teardown_ms = 0;
+};
+
+// Лучшие времена построения и освобождения из repeats запусков
+template <typename Make>
+Result Measure(int repeats, Make make) {
+    Result result{{}, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+    for (int i = 0; i < repeats; ++i) {
+        std::optional<decltype(make())> value;
+        const auto build_start = bench::Clock::now();
+        result.allocations = bench::CountAllocations([&] {
+            value.emplace(make());
+        });
+        result.build_ms = std::min(result.build_ms, bench::GetMilliseconds(build_start));
+
+        const auto teardown_start = bench::Clock::now();
+        value.reset();
+        result.teardown_ms = std::min(result.teardown_ms, bench::GetMilliseconds(teardown_start));
+    }
+    return result;
+}
+
+void PrintResult(const char* name, const Result& result) {
+    std::printf("%s: %zu allocations, %.1f MiB, build %.0f ms, teardown %.1f ms\n", name,
+                result.allocations.count, static_cast<double>(result.allocations.bytes) / (1 << 20),
+                result.build_ms, result.teardown_ms);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int stops = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int buses = argc > 2 ? std::atoi(argv[2]) : 10000;
+    const int repeats = argc > 3 ? std::atoi(argv[3]) : 3;
+
+    std::mt19937 random(3);
+    const std::string document = MakeDocument(stops, buses, random);
+    std::printf("%d stops, %d buses: %.1f MiB document\n", stops, buses,
+                static_cast<double>(document.size()) / (1 << 20));
+
+    PrintResult("json::Load, heap", Measure(repeats, [&] {
+        return json::Load(document, json::NodeStorage::HEAP);
+    }));
+    PrintResult("json::Load, arena", Measure(repeats, [&] {
+        return json::Load(document, json::NodeStorage::ARENA);
+    }));
+
+    // Арена живёт вместе с деревом и освобождается после него
+    struct ArenaTree {
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+        json::Node root;
+    };
+    PrintResult("json::Builder, heap", Measure(repeats, [&] {
+        return BuildResponses(stops, std::pmr::get_default_resource());
+    }));
+    PrintResult("json::Builder, arena", Measure(repeats, [&] {
+        auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>();
+        json::Node root = BuildResponses(stops, arena.get());
+        return ArenaTree{std::move(arena), std::move(root)};
+    }));
+
+    const bool is_equal = json::Load(document, json::NodeStorage::HEAP) == json::Load(document, json::NodeStorage::ARENA);
+    std::printf("heap and arena documents are %s\n", is_equal ? "equal" : "DIFFERENT");
+    return is_equal ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,205 @@
+// Размер и время вывода ответов на запросы Bus, Stop и Route. Сравнивает прежний вывод
+// с отступами, где каждый токен и каждый пробел отступа — отдельный вызов потока,
+// с json::Print через буфер в режимах PRETTY и COMPACT и с потоковым json::Writer.
+// Выведенный текст разбирается обратно и сравнивается с исходным деревом.
+// Запуск: json_print_bench [responses] [repeats]
+
+#include "bench_timing.h"
+#include "json.h"
+#include "json_builder.h"
+#include "json_writer.h"
+
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using namespace std::literals;
+
+// Прежний json::Print: вызов потока на каждый токен и на каждый пробел отступа
+class StreamPrinter {
+public:
+    explicit StreamPrinter(std::ostream& out)
+        : out_(out) {
+    }
+
+    void Print(const json::Node& node, int indent = 0) {
+        if (node.IsDict()) {
+            out_ << "{\n"sv;
+            bool first = true;
+            for (const auto& [key, value] : node.AsDict()) {
+                if (!first) {
+                    out_ << ",\n"sv;
+                }
+                first = false;
+                PrintIndent(indent + 4);
+                PrintString(key);
+                out_ << ": "sv;
+                Print(value, indent + 4);
+            }
+            out_.put('\n');
+            PrintIndent(indent);
+            out_.put('}');
+        } else if (node.IsArray()) {
+            out_ << "[\n"sv;
+            bool first = true;
+            for (const json::Node& value : node.AsArray()) {
+                if (!first) {
+                    out_ << ",\n"sv;
+                }
+                first = false;
+                PrintIndent(indent + 4);
+                Print(value, indent + 4);
+            }
+            out_.put('\n');
+            PrintIndent(indent);
+            out_.put(']');
+        } else if (node.IsString()) {
+            PrintString(node.AsString());
+        } else if (node.IsInt()) {
+            out_ << node.AsInt();
+        } else if (node.IsPureDouble()) {
+            out_ << node.AsDouble();
+        } else if (node.IsBool()) {
+            out_ << (node.AsBool() ? "true"sv : "false"sv);
+        } else {
+            out_ << "null"sv;
+        }
+    }
+
+private:
+    void PrintIndent(int indent) {
+        for (int i = 0; i < indent; ++i) {
+            out_.put(' ');
+        }
+    }
+
+    void PrintString(std::string_view value) {
+        out_.put('"');
+        for (const char c : value) {
+            if (c == '"' || c == '\\') {
+                out_.put('\\');
+            }
+            out_.put(c);
+        }
+        out_.put('"');
+    }
+
+    std::ostream& out_;
+};
+
+// Значения double нецелые: целое число выводится без дробной части и читается обратно как int
+json::Node MakeResponses(int count, std::mt19937& random) {
+    json::Builder builder;
+    json::Builder::ArrayRef responses = builder.StartArray();
+    for (int id = 0; id < count; ++id) {
+        json::Builder::DictRef response = responses.StartDict().Key("request_id").Value(id);
+        switch (id % 3) {
+            case 0:
+                response.Key("curvature").Value(1 + (1 + random() % 99999) / 1e5)
+                        .Key("route_length").Value(static_cast<int>(1000 + random() % 90000))
+                        .Key("stop_count").Value(static_cast<int>(2 + random() % 40))
+                        .Key("unique_stop_count").Value(static_cast<int>(2 + random() % 20));
+                break;
+            case 1: {
+                json::Builder::ArrayRef buses = response.Key("buses").StartArray();
+                for (unsigned i = 0; i < 1 + random() % 6; ++i) {
+                    buses.Value(std::string("Bus ").append(std::to_string(random() % 1000)));
+                }
+                buses.EndArray();
+                break;
+            }
+            default: {
+                json::Builder::ArrayRef items = response.Key("items").StartArray();
+                double total_time = 0;
+                for (unsigned i = 0; i < 1 + random() % 3; ++i) {
+                    const double ride_time = random() % 4000 / 100.0 + 0.001;
+                    items.StartDict()
+                            .Key("stop_name").Value(std::string("Stop ").append(std::to_string(random() % 100000)))
+                            .Key("time").Value(6)
+                            .Key("type").Value("Wait"s)
+                        .EndDict()
+                        .StartDict()
+                            .Key("bus").Value(std::string("Bus ").append(std::to_string(random() % 1000)))
+                            .Key("span_count").Value(static_cast<int>(1 + random() % 10))
+                            .Key("time").Value(ride_time)
+                            .Key("type").Value("Bus"s)
+                        .EndDict();
+                    total_time += 6 + ride_time;
+                }
+                items.EndArray();
+                response.Key("total_time").Value(total_time);
+            }
+        }
+        response.EndDict();
+    }
+    return responses.EndArray().Build();
+}
+
+// Выводит узел через Writer так же, как его выводит Print
+void WriteNode(json::Writer& writer, const json::Node& node) {
+    if (node.IsDict()) {
+        writer.StartDict();
+        for (const auto& [key, value] : node.AsDict()) {
+            writer.Key(key);
+            WriteNode(writer, value);
+        }
+        writer.EndDict();
+    } else if (node.IsArray()) {
+        writer.StartArray();
+        for (const json::Node& value : node.AsArray()) {
+            WriteNode(writer, value);
+        }
+        writer.EndArray();
+    } else if (node.IsString()) {
+        writer.String(node.AsString());
+    } else {
+        writer.Value(node);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 300000;
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::mt19937 random(3);
+    const json::Document document{MakeResponses(count, random)};
+    std::printf("%d responses\n", count);
+
+    bool is_round_trip = true;
+    auto run = [&](const char* name, auto print, bool check) {
+        std::string output;
+        const double ms = bench::MeasureBest(repeats, [&] {
+            std::ostringstream out;
+            print(out);
+            output = std::move(out).str();
+        });
+        std::printf("%s: %.1f MiB, %.0f ms\n", name, static_cast<double>(output.size()) / (1 << 20), ms);
+        if (check && !(json::Load(output) == document)) {
+            std::printf("%s: the output does not parse back to the same document\n", name);
+            is_round_trip = false;
+        }
+    };
+
+    // Прежний вывод печатает double с точностью 6 знаков, поэтому обратно не сверяется
+    run("per-token stream, pretty", [&](std::ostream& out) {
+        StreamPrinter(out).Print(document.GetRoot());
+    }, false);
+    run("json::Print, pretty", [&](std::ostream& out) {
+        json::Print(document, out, json::PrintStyle::PRETTY);
+    }, true);
+    run("json::Print, compact", [&](std::ostream& out) {
+        json::Print(document, out, json::PrintStyle::COMPACT);
+    }, true);
+    run("json::Writer, compact", [&](std::ostream& out) {
+        json::Writer writer(out, json::PrintStyle::COMPACT);
+        WriteNode(writer, document.GetRoot());
+        writer.Finish();
+    }, true);
+
+    return is_round_trip ? EXIT_SUCCESS : EXIT_FAILURE;
+}
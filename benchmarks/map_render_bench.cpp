@@ -0,0 +1,150 @@
+// Вывод чисел в ответе с картой. Сначала форматирование координат: поток с точностью
+// по умолчанию (6 знаков, с потерей точности) и с точностью 17 знаков против
+// format::FormattedDouble в кратчайшей записи и с 6 значащими цифрами. Затем отрисовка
+// карты синтетической сети и вывод ответа с ней через json::Print.
+// Проверяет, что кратчайшая запись читается обратно без потерь, а запись с 6 знаками
+// совпадает с выводом потока.
+// Запуск: map_render_bench [stops] [buses] [stops_per_bus] [numbers] [repeats]
+
+#include "bench_network.h"
+#include "double_format.h"
+#include "json.h"
+#include "map_renderer.h"
+
+#include <charconv>
+#include <iomanip>
+#include <sstream>
+
+using namespace transport_catalogue;
+
+namespace {
+
+// Настройки отрисовки из типичного запроса
+MapRenderer::Settings MakeSettings() {
+    MapRenderer::Settings settings;
+    settings.width = 1200;
+    settings.height = 600;
+    settings.padding = 30;
+    settings.line_width = 14;
+    settings.stop_radius = 5;
+    settings.bus_label_font_size = 20;
+    settings.bus_label_offset = {7, 15};
+    settings.stop_label_font_size = 20;
+    settings.stop_label_offset = {7, -3};
+    settings.underlayer_color = svg::Rgba{255, 255, 255, 0.85};
+    settings.underlayer_width = 3;
+    settings.color_palette = {"green", svg::Rgb{255, 160, 0}, "red", svg::Rgba{1, 2, 3, 0.85}};
+    return settings;
+}
+
+bool ReadsBack(std::string_view text, double value) {
+    double parsed = 0;
+    std::from_chars(text.data(), text.data() + text.size(), parsed);
+    return parsed == value;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const bench::NetworkParams params = bench::ParseNetworkParams(argc, argv, 1, {20000, 2000, 20});
+    const size_t numbers_count = argc > 4 ? std::atoi(argv[4]) : 1000000;
+    const int repeats = argc > 5 ? std::atoi(argv[5]) : 3;
+
+    // Координаты на холсте карты шириной 1200
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> coordinate(30, 1170);
+    std::vector<double> numbers(numbers_count);
+    for (double& number : numbers) {
+        number = coordinate(random);
+    }
+
+    size_t stream_lossy = 0;
+    size_t shortest_lossy = 0;
+    size_t significant_mismatches = 0;
+    for (double number : numbers) {
+        std::ostringstream out;
+        out << number;
+        const std::string stream_text = out.str();
+        stream_lossy += !ReadsBack(stream_text, number);
+        shortest_lossy += !ReadsBack(format::FormattedDouble(number, format::Precision::Shortest()).View(), number);
+        significant_mismatches +=
+            format::FormattedDouble(number, format::Precision::Significant(6)).View() != stream_text;
+    }
+
+    auto run_stream = [&](const char* name, int precision) {
+        size_t size = 0;
+        const double ms = bench::MeasureBest(repeats, [&] {
+            std::ostringstream out;
+            out << std::setprecision(precision);
+            for (double number : numbers) {
+                out << number << ' ';
+            }
+            size = out.view().size();
+        });
+        std::printf("%s: %.1f ns per number, %zu bytes\n", name, ms * 1e6 / numbers.size(), size);
+    };
+    auto run_formatted = [&](const char* name, format::Precision precision) {
+        size_t size = 0;
+        const double ms = bench::MeasureBest(repeats, [&] {
+            std::string out;
+            for (double number : numbers) {
+                out += format::FormattedDouble(number, precision).View();
+                out += ' ';
+            }
+            size = out.size();
+        });
+        std::printf("%s: %.1f ns per number, %zu bytes\n", name, ms * 1e6 / numbers.size(), size);
+    };
+
+    std::printf("%zu canvas coordinates\n", numbers.size());
+    run_stream("ostream, precision 6", 6);
+    run_stream("ostream, precision 17", 17);
+    run_formatted("FormattedDouble, 6 digits", format::Precision::Significant(6));
+    run_formatted("FormattedDouble, shortest", format::Precision::Shortest());
+    std::printf("read back differently: %zu with precision 6, %zu in the shortest form\n", stream_lossy,
+                shortest_lossy);
+
+    TransportCatalogue catalogue;
+    bench::FillNetwork(catalogue, params, random);
+
+    // Маршруты и остановки с маршрутами по названию, как их отдаёт RequestHandler::RenderMap
+    std::vector<Bus> buses;
+    for (BusId id = 0; id < catalogue.GetBusesCount(); ++id) {
+        buses.push_back(catalogue.GetBus(id));
+    }
+    std::sort(buses.begin(), buses.end(), [](const Bus& lhs, const Bus& rhs) {
+        return lhs.title < rhs.title;
+    });
+    std::vector<Stop> stops;
+    for (StopId id : bench::GetServedStops(catalogue)) {
+        stops.push_back(catalogue.GetStop(id));
+    }
+    std::sort(stops.begin(), stops.end(), [](const Stop& lhs, const Stop& rhs) {
+        return lhs.title < rhs.title;
+    });
+
+    MapRenderer renderer;
+    renderer.SetSettings(MakeSettings());
+    std::string map;
+    const double render_ms = bench::MeasureBest(repeats, [&] {
+        map = renderer.Render(buses, stops, catalogue.GetStopsCoordinates());
+    });
+    std::printf("%d stops, %d buses: map %.1f MiB, rendered in %.0f ms\n", params.stops, params.buses,
+                static_cast<double>(map.size()) / (1 << 20), render_ms);
+
+    json::Dict response;
+    response.emplace("map", json::Node(std::move(map)));
+    response.emplace("request_id", json::Node(1));
+    const json::Document document{json::Node(json::Array{json::Node(std::move(response))})};
+    size_t response_size = 0;
+    const double print_ms = bench::MeasureBest(repeats, [&] {
+        std::ostringstream out;
+        json::Print(document, out);
+        response_size = out.view().size();
+    });
+    std::printf("response with the map: %.1f MiB, printed in %.0f ms\n",
+                static_cast<double>(response_size) / (1 << 20), print_ms);
+
+    std::printf("%zu numbers formatted differently from ostream with 6 digits\n", significant_mismatches);
+    return shortest_lossy == 0 && significant_mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
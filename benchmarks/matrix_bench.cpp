@@ -0,0 +1,72 @@
+// Пропускная способность ComputeMatrix в ячейках в секунду на синтетической сети:
+// поиск из каждой строки по обычному графу, корзины по иерархии сжатия и для сравнения
+// отдельный FindRoute на каждую ячейку.
+// Запуск: matrix_bench [stops] [buses] [stops_per_bus] [size] [threads]
+
+#include "bench_network.h"
+#include "transport_router.h"
+
+using namespace transport_catalogue;
+
+int main(int argc, char* argv[]) {
+    const bench::NetworkParams params = bench::ParseNetworkParams(argc, argv);
+    const size_t size = argc > 4 ? std::atoi(argv[4]) : 300;
+    const unsigned threads = argc > 5 ? std::atoi(argv[5]) : 0;
+
+    std::mt19937 random(3);
+    TransportCatalogue catalogue;
+    bench::FillNetwork(catalogue, params, random);
+
+    TransportRouter router(catalogue, {6, 40});
+    std::printf("%d stops, %d buses, %d stops per bus: %zu edges, %zux%zu matrix, threads %u (0 - all cores)\n",
+                params.stops, params.buses, params.stops_per_bus, router.GetEdgeCount(), size, size, threads);
+
+    const std::vector<StopId> served = bench::GetServedStops(catalogue);
+    std::vector<StopId> from(size);
+    std::vector<StopId> to(size);
+    for (StopId& stop : from) {
+        stop = served[random() % served.size()];
+    }
+    for (StopId& stop : to) {
+        stop = served[random() % served.size()];
+    }
+
+    auto run_matrix = [&](const char* name) {
+        const auto start = bench::Clock::now();
+        std::vector<double> matrix = router.ComputeMatrix(from, to, threads);
+        const double seconds = bench::GetMilliseconds(start) / 1000;
+        std::printf("%s: %.2f s, %.3g cells/s\n", name, seconds, static_cast<double>(matrix.size()) / seconds);
+        return matrix;
+    };
+
+    // Несколько строк отдельными FindRoute: столько же поиска, сколько без ComputeMatrix
+    auto run_find_route = [&](const char* name, size_t rows) {
+        TransportRouter::Workspace workspace(router);
+        const auto start = bench::Clock::now();
+        for (size_t row = 0; row < rows; ++row) {
+            for (StopId target : to) {
+                router.FindRoute(from[row], target, workspace);
+            }
+        }
+        const double seconds = bench::GetMilliseconds(start) / 1000;
+        std::printf("%s: %.3g cells/s\n", name, static_cast<double>(rows * size) / seconds);
+    };
+
+    const std::vector<double> plain = run_matrix("plain ComputeMatrix");
+    run_find_route("plain FindRoute per cell", 1);
+
+    const auto contract_start = bench::Clock::now();
+    router.Contract();
+    std::printf("Contract: %.0f ms\n", bench::GetMilliseconds(contract_start));
+
+    const std::vector<double> contracted = run_matrix("contracted ComputeMatrix");
+    run_find_route("contracted FindRoute per cell", std::min<size_t>(size, 20));
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < plain.size(); ++i) {
+        const bool both_unreachable = std::isinf(plain[i]) && std::isinf(contracted[i]);
+        mismatches += !both_unreachable && !(std::abs(plain[i] - contracted[i]) <= 1e-9 * std::max(1.0, plain[i]));
+    }
+    std::printf("%zu mismatching cells\n", mismatches);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,101 @@
+// Поиск по названиям в StringPool до и после Freeze на 10 тысячах, 100 тысячах и миллионе
+// названий: среднее время поиска существующего и отсутствующего названия и время
+// построения совершенной хеш-функции. Проверяет, что замороженный пул находит те же строки.
+// Запуск: name_lookup_bench [max_names] [lookups] [repeats]
+
+#include "bench_timing.h"
+#include "string_pool.h"
+
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace transport_catalogue;
+
+namespace {
+
+// Поиски в случайном порядке из общего буфера, чтобы искомые строки не лежали в кэше вместе с пулом
+class Lookups {
+public:
+    Lookups(const std::vector<std::string>& names, size_t count, std::mt19937& random) {
+        std::vector<size_t> offsets;
+        for (size_t i = 0; i < count; ++i) {
+            const std::string& name = names[random() % names.size()];
+            offsets.push_back(buffer_.size());
+            buffer_ += name;
+            sizes_.push_back(name.size());
+        }
+        for (size_t i = 0; i < count; ++i) {
+            keys_.emplace_back(buffer_.data() + offsets[i], sizes_[i]);
+        }
+    }
+
+    const std::vector<std::string_view>& GetKeys() const {
+        return keys_;
+    }
+
+private:
+    std::string buffer_;
+    std::vector<size_t> sizes_;
+    std::vector<std::string_view> keys_;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int max_names = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const size_t lookups_count = argc > 2 ? std::atoi(argv[2]) : 2000000;
+    const int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    size_t mismatches = 0;
+    for (const int names_count : {max_names / 100, max_names / 10, max_names}) {
+        std::mt19937 random(3);
+        std::vector<std::string> names(names_count);
+        std::vector<std::string> missing(names_count);
+        for (int i = 0; i < names_count; ++i) {
+            names[i] = std::string(i % 3 ? "Stop " : "Bus ").append(std::to_string(random() % 100000000))
+                               .append(i % 2 ? " Street " : " ").append(std::to_string(i));
+            missing[i] = std::string("Missing ").append(std::to_string(i));
+        }
+        const Lookups hits(names, lookups_count, random);
+        const Lookups misses(missing, lookups_count, random);
+
+        StringPool pool;
+        StringPool frozen;
+        for (const std::string& name : names) {
+            pool.Intern(name);
+            frozen.Intern(name);
+        }
+        const auto freeze_start = bench::Clock::now();
+        frozen.Freeze();
+        std::printf("%d names: Freeze %.0f ms\n", names_count, bench::GetMilliseconds(freeze_start));
+
+        for (StringPool::Handle handle = 0; handle < names.size(); ++handle) {
+            mismatches += frozen.Find(names[handle]) != handle || pool.Find(names[handle]) != handle;
+        }
+        for (const std::string& name : missing) {
+            mismatches += frozen.Find(name).has_value();
+        }
+
+        auto run = [&](const char* name, const StringPool& searched, const Lookups& lookups) {
+            size_t found = 0;
+            const double ms = bench::MeasureBest(repeats, [&] {
+                found = 0;
+                for (std::string_view key : lookups.GetKeys()) {
+                    found += searched.Find(key).has_value();
+                }
+            });
+            std::printf("  %s: %.1f ns per lookup, %zu found\n", name, ms * 1e6 / lookups.GetKeys().size(), found);
+        };
+        run("index, existing", pool, hits);
+        run("index, missing", pool, misses);
+        run("frozen, existing", frozen, hits);
+        run("frozen, missing", frozen, misses);
+    }
+
+    std::printf("%zu lookups differ between the index and the frozen pool\n", mismatches);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,155 @@
+// Разбор чисел JSON на документе из остановок с координатами и дорожными расстояниями.
+// Сравнивает преобразование чисел на месте через std::from_chars, как в json::Parse,
+// с прежним способом — временная строка, std::stoi и при переполнении std::stod, —
+// проверяет, что оба дают одинаковые значения, и замеряет разбор всего документа.
+// Запуск: number_parse_bench [stops] [distances_per_stop] [repeats]
+
+#include "bench_timing.h"
+#include "json.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct Number {
+    bool is_int = false;
+    int int_value = 0;
+    double double_value = 0;
+
+    bool operator==(const Number&) const = default;
+};
+
+struct NumberToken {
+    std::string text;
+    // Нет дробной части и экспоненты: такое число сначала пробуют прочитать как int
+    bool is_int = false;
+};
+
+// Прежний LoadNumber
+Number ConvertWithString(std::string_view token, bool is_int) {
+    const std::string parsed_num(token);
+    if (is_int) {
+        try {
+            return {true, std::stoi(parsed_num), 0};
+        } catch (...) {
+        }
+    }
+    return {false, 0, std::stod(parsed_num)};
+}
+
+// То же, что в json::Parse
+Number ConvertInPlace(std::string_view token, bool is_int) {
+    const char* begin = token.data();
+    const char* end = token.data() + token.size();
+    if (is_int) {
+        int value;
+        if (auto [ptr, ec] = std::from_chars(begin, end, value); ec == std::errc{}) {
+            return {true, value, 0};
+        }
+    }
+    double value = 0;
+    std::from_chars(begin, end, value);
+    return {false, 0, value};
+}
+
+// Считает числа, чтобы разбор нельзя было выбросить как неиспользуемый
+class NumberSum final : public json::Handler {
+public:
+    void StartDict() override {}
+    void EndDict() override {}
+    void StartArray() override {}
+    void EndArray() override {}
+    void Key(std::string_view) override {}
+    void String(std::string_view) override {}
+    void Int(int value) override {
+        sum += value;
+    }
+    void Double(double value) override {
+        sum += value;
+    }
+    void Bool(bool) override {}
+    void Null() override {}
+
+    double sum = 0;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int stops = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int distances_per_stop = argc > 2 ? std::atoi(argv[2]) : 4;
+    const int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> latitude(55.5, 56.0);
+    std::uniform_real_distribution<double> longitude(37.3, 37.9);
+
+    std::string document = R"({"base_requests": [)";
+    std::vector<NumberToken> tokens;
+    auto add_number = [&](std::string text, bool is_int) {
+        document += text;
+        tokens.push_back({std::move(text), is_int});
+    };
+
+    char buffer[32];
+    for (int stop = 0; stop < stops; ++stop) {
+        document += stop == 0 ? "{" : ", {";
+        document += R"("type": "Stop", "name": "Stop )" + std::to_string(stop) + R"(", "latitude": )";
+        std::snprintf(buffer, sizeof(buffer), "%.6f", latitude(random));
+        add_number(buffer, false);
+        document += R"(, "longitude": )";
+        std::snprintf(buffer, sizeof(buffer), "%.6f", longitude(random));
+        add_number(buffer, false);
+        document += R"(, "road_distances": {)";
+        for (int i = 0; i < distances_per_stop; ++i) {
+            document += std::string(i == 0 ? "" : ", ") + "\"Stop " + std::to_string(random() % stops) + "\": ";
+            add_number(std::to_string(100 + random() % 5000), true);
+        }
+        document += "}}";
+    }
+    document += "]}";
+
+    // Границы int и переполнение, при котором число становится double
+    for (const char* edge : {"2147483647", "-2147483648", "2147483648", "-2147483649", "0", "-0", "1e3", "-0.0"}) {
+        const std::string_view text = edge;
+        tokens.push_back({std::string(text), text.find_first_of(".eE") == std::string_view::npos});
+    }
+
+    size_t mismatches = 0;
+    for (const NumberToken& token : tokens) {
+        mismatches += !(ConvertWithString(token.text, token.is_int) == ConvertInPlace(token.text, token.is_int));
+    }
+
+    std::printf("%d stops, %zu numbers, %.1f MiB document\n", stops, tokens.size(),
+                static_cast<double>(document.size()) / (1 << 20));
+
+    auto run_conversion = [&](const char* name, Number (*convert)(std::string_view, bool)) {
+        double sum = 0;
+        const double ms = bench::MeasureBest(repeats, [&] {
+            sum = 0;
+            for (const NumberToken& token : tokens) {
+                const Number number = convert(token.text, token.is_int);
+                sum += number.is_int ? number.int_value : number.double_value;
+            }
+        });
+        std::printf("%s: %.1f ms, %.1f ns per number (sum %.6g)\n", name, ms, ms * 1e6 / tokens.size(), sum);
+    };
+    run_conversion("string + stoi/stod", ConvertWithString);
+    run_conversion("from_chars in place", ConvertInPlace);
+
+    NumberSum handler;
+    const double parse_ms = bench::MeasureBest(repeats, [&] {
+        handler.sum = 0;
+        json::Parse(document, handler);
+    });
+    std::printf("json::Parse of the document: %.0f ms, %.0f MiB/s (sum %.6g)\n", parse_ms,
+                static_cast<double>(document.size()) / (1 << 20) / (parse_ms / 1000), handler.sum);
+
+    std::printf("%zu mismatching numbers\n", mismatches);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,52 @@
+// Число запросов FindReachable в секунду на синтетической сети при разных ограничениях
+// времени и расстояния и число выделений памяти во время запросов.
+// Запуск: reachable_bench [stops] [buses] [stops_per_bus] [queries]
+
+#include "allocation_counter.h"
+#include "bench_network.h"
+#include "transport_router.h"
+
+using namespace transport_catalogue;
+
+int main(int argc, char* argv[]) {
+    const bench::NetworkParams params = bench::ParseNetworkParams(argc, argv);
+    const int queries_count = argc > 4 ? std::atoi(argv[4]) : 2000;
+
+    std::mt19937 random(3);
+    TransportCatalogue catalogue;
+    bench::FillNetwork(catalogue, params, random);
+
+    const TransportRouter router(catalogue, {6, 40});
+    std::printf("%d stops, %d buses, %d stops per bus: %zu edges\n", params.stops, params.buses,
+                params.stops_per_bus, router.GetEdgeCount());
+
+    const std::vector<StopId> served = bench::GetServedStops(catalogue);
+    std::vector<StopId> origins(queries_count);
+    for (StopId& origin : origins) {
+        origin = served[random() % served.size()];
+    }
+
+    TransportRouter::Workspace workspace(router);
+    size_t allocations = 0;
+    auto run = [&](const char* name, TransportRouter::CostType cost_type, double max_cost) {
+        const size_t allocations_before = bench::allocations_count;
+        size_t stops = 0;
+        const auto start = bench::Clock::now();
+        for (StopId origin : origins) {
+            stops += router.FindReachable(origin, cost_type, max_cost, workspace).size();
+        }
+        const double seconds = bench::GetMilliseconds(start) / 1000;
+        allocations += bench::allocations_count - allocations_before;
+        std::printf("%s %g: %.0f queries/s, %.0f stops per query\n", name, max_cost, origins.size() / seconds,
+                    static_cast<double>(stops) / origins.size());
+    };
+
+    for (double max_time : {15.0, 30.0, 60.0}) {
+        run("max_time", TransportRouter::CostType::TIME, max_time);
+    }
+    for (double max_distance : {2000.0, 5000.0, 20000.0}) {
+        run("max_distance", TransportRouter::CostType::DISTANCE, max_distance);
+    }
+    std::printf("%zu allocations during queries\n", allocations);
+    return allocations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
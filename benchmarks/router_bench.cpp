@@ -0,0 +1,44 @@
+// Построение графа и задержка FindRoute на синтетической сети.
+// Запуск: router_bench [stops] [buses] [stops_per_bus] [queries]
+
+#include "allocation_counter.h"
+#include "bench_network.h"
+#include "transport_router.h"
+
+using namespace transport_catalogue;
+
+int main(int argc, char* argv[]) {
+    const bench::NetworkParams params = bench::ParseNetworkParams(argc, argv);
+    const int queries_count = argc > 4 ? std::atoi(argv[4]) : 2000;
+
+    std::mt19937 random(3);
+    TransportCatalogue catalogue;
+    bench::FillNetwork(catalogue, params, random);
+
+    const auto build_start = bench::Clock::now();
+    const TransportRouter router(catalogue, {6, 40});
+    std::printf("%d stops, %d buses, %d stops per bus: %zu edges, built in %.0f ms\n", params.stops, params.buses,
+                params.stops_per_bus, router.GetEdgeCount(), bench::GetMilliseconds(build_start));
+
+    const std::vector<StopId> served = bench::GetServedStops(catalogue);
+    std::vector<std::pair<StopId, StopId>> queries(queries_count);
+    for (auto& [from, to] : queries) {
+        from = served[random() % served.size()];
+        to = served[random() % served.size()];
+    }
+
+    TransportRouter::Workspace workspace(router);
+    std::vector<double> latencies;
+    latencies.reserve(queries.size());
+    size_t found = 0;
+    const size_t allocations_before = bench::allocations_count;
+    for (const auto& [from, to] : queries) {
+        const auto start = bench::Clock::now();
+        found += router.FindRoute(from, to, workspace).has_value();
+        latencies.push_back(bench::GetMilliseconds(start) * 1000);
+    }
+    const size_t allocations = bench::allocations_count - allocations_before;
+
+    bench::PrintLatency("FindRoute", std::move(latencies));
+    std::printf("%zu routes found, %zu allocations during queries\n", found, allocations);
+}
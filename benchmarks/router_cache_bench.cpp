@@ -0,0 +1,92 @@
+// Холодный старт маршрутизации против загрузки из кэша: построение графа (и иерархии
+// сжатия) по справочнику против TransportRouter::Load из файла, записанного Save, вместе
+// с проверкой содержимого файла. Проверяет, что загруженный граф находит те же пути.
+// Запуск: router_cache_bench [stops] [buses] [stops_per_bus] [queries]
+
+#include "bench_network.h"
+#include "transport_router.h"
+
+#include <filesystem>
+#include <optional>
+
+using namespace transport_catalogue;
+
+namespace {
+
+// Число запросов, на которые загруженный граф ответил не так, как построенный
+size_t CountDifferences(const TransportRouter& built, const TransportRouter& loaded,
+                        const std::vector<std::pair<StopId, StopId>>& queries) {
+    TransportRouter::Workspace built_workspace(built);
+    TransportRouter::Workspace loaded_workspace(loaded);
+    size_t differences = 0;
+    for (const auto& [from, to] : queries) {
+        const std::optional<TransportRouter::Route> expected = built.FindRoute(from, to, built_workspace);
+        const std::optional<TransportRouter::Route> actual = loaded.FindRoute(from, to, loaded_workspace);
+        differences += expected.has_value() != actual.has_value()
+                       || (expected && (expected->total_time != actual->total_time
+                                        || expected->rides.size() != actual->rides.size()));
+    }
+    return differences;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const bench::NetworkParams params = bench::ParseNetworkParams(argc, argv);
+    const int queries_count = argc > 4 ? std::atoi(argv[4]) : 1000;
+    const RoutingSettings settings{6, 40};
+
+    std::mt19937 random(3);
+    TransportCatalogue catalogue;
+    bench::FillNetwork(catalogue, params, random);
+
+    const std::vector<StopId> served = bench::GetServedStops(catalogue);
+    std::vector<std::pair<StopId, StopId>> queries(queries_count);
+    for (auto& [from, to] : queries) {
+        from = served[random() % served.size()];
+        to = served[random() % served.size()];
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "router_cache_bench.bin").string();
+    std::printf("%d stops, %d buses, %d stops per bus\n", params.stops, params.buses, params.stops_per_bus);
+
+    size_t differences = 0;
+    for (const bool contract : {false, true}) {
+        const char* name = contract ? "with hierarchy" : "graph only";
+        const auto build_start = bench::Clock::now();
+        TransportRouter built(catalogue, settings);
+        if (contract) {
+            built.Contract();
+        }
+        const double build_ms = bench::GetMilliseconds(build_start);
+
+        const auto save_start = bench::Clock::now();
+        built.Save(path);
+        const double save_ms = bench::GetMilliseconds(save_start);
+        const uintmax_t file_size = std::filesystem::file_size(path);
+
+        const auto load_start = bench::Clock::now();
+        const std::optional<TransportRouter> loaded = TransportRouter::Load(path, catalogue, settings);
+        const double load_ms = bench::GetMilliseconds(load_start);
+        if (!loaded) {
+            std::printf("%s: the saved file is rejected by Load\n", name);
+            ++differences;
+            continue;
+        }
+
+        const size_t route_differences = CountDifferences(built, *loaded, queries);
+        std::printf("%s: build %.0f ms, save %.0f ms, load %.0f ms (%.1fx), %.1f MiB, %zu routes differ\n", name,
+                    build_ms, save_ms, load_ms, build_ms / load_ms, static_cast<double>(file_size) / (1 << 20),
+                    route_differences);
+        differences += route_differences;
+    }
+
+    // Справочник с другим числом остановок: файл должен быть отвергнут
+    TransportCatalogue other;
+    bench::FillNetwork(other, {params.stops / 2, params.buses / 2, params.stops_per_bus}, random);
+    const bool is_other_rejected = !TransportRouter::Load(path, other, settings).has_value();
+    std::printf("file for another catalogue is %s\n", is_other_rejected ? "rejected" : "ACCEPTED");
+
+    std::filesystem::remove(path);
+    return differences == 0 && is_other_rejected ? EXIT_SUCCESS : EXIT_FAILURE;
+}
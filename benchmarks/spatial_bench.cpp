@@ -0,0 +1,125 @@
+// Задержки FindNearestStops, FindStopsWithinRadius и FindStopsInBox на синтетических
+// сетях из max_stops / 100, max_stops / 10 и max_stops остановок, а также время построения
+// пространственного индекса при первом запросе. На самой большой сети часть ответов
+// сверяется с полным перебором.
+// Запуск: spatial_bench [max_stops] [queries] [checked_queries]
+
+#include "bench_network.h"
+#include "geo.h"
+
+#include <algorithm>
+
+using namespace transport_catalogue;
+
+namespace {
+
+constexpr size_t NEAREST_COUNT = 10;
+constexpr double RADIUS = 300;
+// Полуразмеры прямоугольника: около 5 шагов сетки в каждую сторону
+constexpr double BOX_HALF_LAT = 0.01;
+constexpr double BOX_HALF_LNG = 0.015;
+
+struct Query {
+    geo::Coordinates center;
+    geo::Coordinates south_west;
+    geo::Coordinates north_east;
+};
+
+// Сверяет ответы с перебором всех остановок. Ближайшие сравниваются по расстояниям,
+// потому что равноудалённые остановки могут идти в любом порядке
+size_t CountMismatches(const TransportCatalogue& catalogue, const Query& query) {
+    const std::span<const geo::Coordinates> coords = catalogue.GetStopsCoordinates();
+    std::vector<double> distances(coords.size());
+    std::vector<StopId> in_box;
+    for (StopId id = 0; id < coords.size(); ++id) {
+        distances[id] = geo::ComputeHaversineDistance(query.center, coords[id]);
+        if (coords[id].lat >= query.south_west.lat && coords[id].lat <= query.north_east.lat
+            && coords[id].lng >= query.south_west.lng && coords[id].lng <= query.north_east.lng) {
+            in_box.push_back(id);
+        }
+    }
+
+    size_t mismatches = 0;
+    std::vector<double> sorted = distances;
+    const size_t nearest_count = std::min(NEAREST_COUNT, sorted.size());
+    std::partial_sort(sorted.begin(), sorted.begin() + nearest_count, sorted.end());
+    const std::vector<StopId> nearest = catalogue.FindNearestStops(query.center, NEAREST_COUNT);
+    mismatches += nearest.size() != nearest_count;
+    for (size_t i = 0; i < std::min(nearest.size(), nearest_count); ++i) {
+        mismatches += std::abs(distances[nearest[i]] - sorted[i]) > 1e-3;
+    }
+
+    const size_t within_radius = std::count_if(distances.begin(), distances.end(), [](double distance) {
+        return distance <= RADIUS;
+    });
+    mismatches += catalogue.FindStopsWithinRadius(query.center, RADIUS).size() != within_radius;
+    mismatches += catalogue.FindStopsInBox(query.south_west, query.north_east) != in_box;
+    return mismatches;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int max_stops = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int queries_count = argc > 2 ? std::atoi(argv[2]) : 20000;
+    const int checked_queries = argc > 3 ? std::atoi(argv[3]) : 100;
+
+    size_t mismatches = 0;
+    for (const int stops : {max_stops / 100, max_stops / 10, max_stops}) {
+        // Маршруты индексу не нужны, но сеть с ними похожа на настоящую
+        const bench::NetworkParams params{stops, std::max(1, stops / 100), 20};
+        std::mt19937 random(3);
+        TransportCatalogue catalogue;
+        bench::FillNetwork(catalogue, params, random);
+
+        // Точки запросов равномерно по всей площади сети
+        const std::span<const geo::Coordinates> coords = catalogue.GetStopsCoordinates();
+        const auto [min_lng, max_lng] = std::minmax_element(coords.begin(), coords.end(), [](auto lhs, auto rhs) {
+            return lhs.lng < rhs.lng;
+        });
+        std::uniform_real_distribution<double> lat(coords.front().lat, coords.back().lat);
+        std::uniform_real_distribution<double> lng(min_lng->lng, max_lng->lng);
+        std::vector<Query> queries(queries_count);
+        for (Query& query : queries) {
+            query.center = {lat(random), lng(random)};
+            query.south_west = {query.center.lat - BOX_HALF_LAT, query.center.lng - BOX_HALF_LNG};
+            query.north_east = {query.center.lat + BOX_HALF_LAT, query.center.lng + BOX_HALF_LNG};
+        }
+
+        const auto build_start = bench::Clock::now();
+        catalogue.FindNearestStops(queries.front().center, 1);
+        std::printf("%d stops: index built on the first query in %.0f ms\n", stops,
+                    bench::GetMilliseconds(build_start));
+
+        size_t found = 0;
+        auto run = [&](const char* name, auto find) {
+            std::vector<double> latencies;
+            latencies.reserve(queries.size());
+            for (const Query& query : queries) {
+                const auto start = bench::Clock::now();
+                found += find(query).size();
+                latencies.push_back(bench::GetMilliseconds(start) * 1000);
+            }
+            bench::PrintLatency(name, std::move(latencies));
+        };
+        run("  FindNearestStops, 10", [&](const Query& query) {
+            return catalogue.FindNearestStops(query.center, NEAREST_COUNT);
+        });
+        run("  FindStopsWithinRadius, 300 m", [&](const Query& query) {
+            return catalogue.FindStopsWithinRadius(query.center, RADIUS);
+        });
+        run("  FindStopsInBox", [&](const Query& query) {
+            return catalogue.FindStopsInBox(query.south_west, query.north_east);
+        });
+        std::printf("  %.1f stops per query on average\n", static_cast<double>(found) / (3.0 * queries.size()));
+
+        if (stops == max_stops) {
+            for (int i = 0; i < std::min(checked_queries, queries_count); ++i) {
+                mismatches += CountMismatches(catalogue, queries[i]);
+            }
+            std::printf("%zu answers differ from a full scan\n", mismatches);
+        }
+    }
+
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,115 @@
+// Пропускная способность читателей VersionedCatalogue без обновлений и во время них.
+// Читатели берут снимок на пачку запросов, как RequestHandler на пачку stat_requests,
+// и ищут остановки и маршруты по названиям, их статистику и маршруты остановок.
+// Писатель с заданной частотой публикует версии: каждая добавляет остановку с расстоянием
+// до существующей и маршрут через них. Выводит запросы читателей в секунду в обеих фазах
+// и задержку обновлений. Проверяет, что последняя версия содержит все добавленное.
+// Запуск: versioned_catalogue_bench [stops] [buses] [stops_per_bus] [readers] [updates_per_second] [seconds]
+
+#include "bench_network.h"
+#include "versioned_catalogue.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace transport_catalogue;
+
+namespace {
+
+constexpr int QUERIES_PER_SNAPSHOT = 100;
+
+std::string MakeAddedTitle(int update) {
+    return std::string("Added ").append(std::to_string(update));
+}
+
+// Запросов в секунду у всех читателей вместе за seconds секунд
+double MeasureReaders(const VersionedCatalogue& catalogue, const bench::Network& network, int readers_count,
+                      double seconds) {
+    std::atomic<bool> done = false;
+    std::atomic<uint64_t> total_queries = 0;
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < readers_count; ++reader) {
+        readers.emplace_back([&, reader] {
+            std::mt19937 random(reader);
+            uint64_t queries = 0;
+            size_t found = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                const VersionedCatalogue::Snapshot snapshot = catalogue.GetSnapshot();
+                for (int i = 0; i < QUERIES_PER_SNAPSHOT; ++i) {
+                    const std::string& stop = network.stop_titles[random() % network.stop_titles.size()];
+                    const std::string& bus = network.bus_titles[random() % network.bus_titles.size()];
+                    found += snapshot->GetBusesOfStop(stop).size();
+                    found += snapshot->GetBusStats(bus)->stops_amount;
+                }
+                queries += 2 * QUERIES_PER_SNAPSHOT;
+            }
+            total_queries += queries + found % 2;
+        });
+    }
+
+    const auto start = bench::Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    return total_queries.load() / (bench::GetMilliseconds(start) / 1000);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const bench::NetworkParams params = bench::ParseNetworkParams(argc, argv);
+    const int readers_count = argc > 4 ? std::atoi(argv[4]) : 2;
+    const int updates_per_second = argc > 5 ? std::atoi(argv[5]) : 100;
+    const double seconds = argc > 6 ? std::atof(argv[6]) : 3;
+
+    std::mt19937 random(3);
+    const bench::Network network = bench::MakeNetwork(params, random);
+    auto initial = std::make_unique<TransportCatalogue>();
+    initial->AddBulk(network.data, 1);
+    VersionedCatalogue catalogue(std::move(initial));
+    std::printf("%d stops, %d buses, %d readers\n", params.stops, params.buses, readers_count);
+
+    const double idle_rate = MeasureReaders(catalogue, network, readers_count, seconds);
+    std::printf("readers without updates: %.2f M queries/s\n", idle_rate / 1e6);
+
+    // Писатель публикует версии по расписанию, пока читатели работают
+    std::atomic<bool> writing = true;
+    std::vector<double> latencies;
+    std::thread writer([&] {
+        const auto period = std::chrono::duration<double>(1.0 / updates_per_second);
+        auto next = bench::Clock::now();
+        for (int update = 1; writing.load(std::memory_order_relaxed); ++update) {
+            const std::string stop = MakeAddedTitle(update);
+            const std::string& neighbour = network.stop_titles[update % network.stop_titles.size()];
+            const auto start = bench::Clock::now();
+            catalogue.Update([&](TransportCatalogue& next_version) {
+                next_version.AddStop(stop, {55.0, 37.0});
+                next_version.SetStopsDistance(stop, neighbour, 500);
+                next_version.AddBus(stop, {stop, neighbour, stop}, true);
+            });
+            latencies.push_back(bench::GetMilliseconds(start) * 1000);
+
+            next += std::chrono::duration_cast<bench::Clock::duration>(period);
+            std::this_thread::sleep_until(next);
+        }
+    });
+    const double writing_rate = MeasureReaders(catalogue, network, readers_count, seconds);
+    writing = false;
+    writer.join();
+
+    std::printf("readers during %d updates/s: %.2f M queries/s, %.0f%% of the rate without updates\n",
+                updates_per_second, writing_rate / 1e6, 100 * writing_rate / idle_rate);
+    const size_t updates = latencies.size();
+    bench::PrintLatency("Update", std::move(latencies));
+
+    const VersionedCatalogue::Snapshot last = catalogue.GetSnapshot();
+    size_t missing = last.version != updates;
+    for (size_t update = 1; update <= updates; ++update) {
+        const std::optional<BusStats> stats = last->GetBusStats(MakeAddedTitle(update));
+        missing += !stats || stats->route_length != 1000;
+    }
+    std::printf("%zu of %zu updates are missing from the last version\n", missing, updates);
+    return missing == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,77 @@
+#include "distance_table.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace transport_catalogue {
+
+namespace {
+
+// Перемешивает биты ключа (финальный шаг splitmix64), чтобы соседние
+// идентификаторы не попадали в соседние ячейки
+uint64_t Mix(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+}  // namespace
+
+void DistanceTable::Set(StopId from, StopId to, int distance) {
+    if ((size_ + 1) * 2 > entries_.size()) {
+        Rehash(std::max<size_t>(entries_.size() * 2, 16));
+    }
+
+    const uint64_t key = MakeKey(from, to);
+    Entry& entry = entries_.Mutable(FindSlot(key));
+    if (entry.key == EMPTY_KEY) {
+        entry.key = key;
+        ++size_;
+    }
+    entry.distance = distance;
+}
+
+std::optional<int> DistanceTable::Find(StopId from, StopId to) const {
+    if (entries_.empty()) {
+        return std::nullopt;
+    }
+
+    const Entry& entry = entries_[FindSlot(MakeKey(from, to))];
+    if (entry.key == EMPTY_KEY) {
+        return std::nullopt;
+    }
+
+    return entry.distance;
+}
+
+void DistanceTable::Reserve(size_t count) {
+    const size_t capacity = std::bit_ceil(count * 2);
+    if (capacity > entries_.size()) {
+        Rehash(capacity);
+    }
+}
+
+size_t DistanceTable::FindSlot(uint64_t key) const {
+    const size_t mask = entries_.size() - 1;
+    size_t slot = Mix(key) & mask;
+    while (entries_[slot].key != key && entries_[slot].key != EMPTY_KEY) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void DistanceTable::Rehash(size_t capacity) {
+    const ChunkedArray<Entry> old_entries = std::exchange(entries_, ChunkedArray<Entry>(capacity));
+
+    for (size_t i = 0; i < old_entries.size(); ++i) {
+        if (old_entries[i].key != EMPTY_KEY) {
+            entries_.Mutable(FindSlot(old_entries[i].key)) = old_entries[i];
+        }
+    }
+}
+
+}
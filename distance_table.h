@@ -0,0 +1,53 @@
+#pragma once
+
+#include "domain.h"
+#include "shared_arrays.h"
+
+#include <cstdint>
+#include <optional>
+
+namespace transport_catalogue {
+
+/*
+ * Таблица дорожных расстояний между остановками.
+ * Ключ — пара идентификаторов, упакованная в 64-битное число, хранится в открытой
+ * адресации с линейным пробированием: поиск — одно хеширование и проход по соседним ячейкам.
+ * Копия делит с оригиналом ячейки, пока их не изменят
+ */
+class DistanceTable {
+public:
+    // Задаёт или заменяет расстояние from → to
+    void Set(StopId from, StopId to, int distance);
+
+    // Расстояние from → to, если оно задано. Обратное направление не проверяется
+    std::optional<int> Find(StopId from, StopId to) const;
+
+    // Готовит таблицу к count записям без перестроений
+    void Reserve(size_t count);
+
+    size_t Size() const {
+        return size_;
+    }
+
+private:
+    // Ключ пустой ячейки. Пара с двумя максимальными идентификаторами не встречается
+    static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+
+    struct Entry {
+        uint64_t key = EMPTY_KEY;
+        int distance = 0;
+    };
+
+    static uint64_t MakeKey(StopId from, StopId to) {
+        return (static_cast<uint64_t>(from) << 32) | to;
+    }
+
+    size_t FindSlot(uint64_t key) const;
+    void Rehash(size_t capacity);
+
+    // Размер всегда степень двойки, заполнено не больше половины ячеек
+    ChunkedArray<Entry> entries_;
+    size_t size_ = 0;
+};
+
+}
@@ -2,8 +2,9 @@
 
 #include "geo.h"
 
-#include <string>
-#include <vector>
+#include <cstdint>
+#include <span>
+#include <string_view>
 
 /*
  * В этом файле вы можете разместить классы/структуры, которые являются частью предметной области (domain)
@@ -19,14 +20,22 @@
 
 namespace transport_catalogue {
 
+// Идентификаторы выдаются подряд, начиная с нуля, в порядке добавления в справочник
+using StopId = uint32_t;
+using BusId = uint32_t;
+
+// Stop и Bus — лёгкие представления данных, которые хранит справочник.
+// Они остаются действительными, пока в справочник ничего не добавляется
 struct Stop {
-    std::string title;
+    StopId id = 0;
+    std::string_view title;
     geo::Coordinates coords;
 };
 
 struct Bus {
-    std::string title;
-    std::vector<const Stop*> stops;
+    BusId id = 0;
+    std::string_view title;
+    std::span<const StopId> stops;
     bool is_roundtrip = false;
 };
 
@@ -34,16 +43,8 @@ struct BusStats {
     int stops_amount = 0;
     int uniq_stops_amount = 0;
     int route_length = 0;
+    double geo_length = 0;
     double curvature = 0;
 };
 
-struct PairHash {
-public:
-    template <typename T, typename U>
-    std::size_t operator()(const std::pair<T, U> &x) const
-    {
-        return std::hash<T>()(x.first) ^ std::hash<U>()(x.second);
-    }
-};
-
 }
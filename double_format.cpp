@@ -0,0 +1,18 @@
+#include "double_format.h"
+
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+
+namespace format {
+
+FormattedDouble::FormattedDouble(double value, Precision precision) {
+    // Больше 17 значащих цифр для double не бывает
+    const int digits = std::min(precision.significant_digits, 17);
+    const auto [end, ec] = digits > 0
+        ? std::to_chars(std::begin(buffer_), std::end(buffer_), value, std::chars_format::general, digits)
+        : std::to_chars(std::begin(buffer_), std::end(buffer_), value);
+    size_ = static_cast<size_t>(end - buffer_);
+}
+
+}  // namespace format
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string_view>
+
+namespace format {
+
+// Количество значащих цифр при выводе чисел с плавающей точкой
+struct Precision {
+    // 0 — кратчайшая запись, которая при чтении даёт ровно то же значение
+    int significant_digits = 0;
+
+    static Precision Shortest() {
+        return {0};
+    }
+
+    // Как у std::ostream: digits значащих цифр, экспоненциальная запись
+    // для очень больших и малых значений. Значение по умолчанию в потоках — 6
+    static Precision Significant(int digits) {
+        return {digits};
+    }
+};
+
+/*
+ * Текстовое представление числа double, записанное через std::to_chars
+ * без обращения к потокам, локали и их настройкам точности
+ */
+class FormattedDouble {
+public:
+    FormattedDouble(double value, Precision precision);
+
+    std::string_view View() const {
+        return {buffer_, size_};
+    }
+
+private:
+    // Хватает на 17 значащих цифр, знак, точку и экспоненту
+    char buffer_[32];
+    size_t size_ = 0;
+};
+
+}  // namespace format
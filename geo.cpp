@@ -1,10 +1,134 @@
 #define _USE_MATH_DEFINES
 #include "geo.h"
 
+#include <algorithm>
 #include <cmath>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 namespace geo {
 
+namespace {
+
+/*
+ * Угол по половине длины хорды: 2·asin(half_chord).
+ * На отрезках до ~127 км (half_chord ≤ 0.01) asin заменён рядом Тейлора до x^9:
+ * следующий член меньше 3e-22·x, то есть ниже точности double. Ряд считается
+ * и в векторном коде, поэтому оба варианта выполняют одни и те же операции
+ */
+constexpr double SMALL_HALF_CHORD = 0.01;
+
+double AsinSmall(double x) {
+    const double x2 = x * x;
+    return x + x * x2 * (1.0 / 6 + x2 * (3.0 / 40 + x2 * (5.0 / 112 + x2 * (35.0 / 1152))));
+}
+
+double HalfChordToAngle(double half_chord) {
+    return 2 * (half_chord <= SMALL_HALF_CHORD ? AsinSmall(half_chord) : std::asin(std::min(half_chord, 1.0)));
+}
+
+double HalfChord(SpherePoint from, SpherePoint to) {
+    const double dx = from.x - to.x;
+    const double dy = from.y - to.y;
+    const double dz = from.z - to.z;
+    return std::sqrt((dx * dx + dy * dy) + dz * dz) * 0.5;
+}
+
+// Отрезок i суммируется в sums[i % 4] — так же, как в векторной версии по дорожкам,
+// поэтому порядок округлений у них совпадает
+double FinishRouteLength(const SpherePoint* points, const uint32_t* route, size_t size, size_t i, double sums[4]) {
+    for (; i + 1 < size; ++i) {
+        sums[i % 4] += HalfChordToAngle(HalfChord(points[route[i]], points[route[i + 1]]));
+    }
+    return ((sums[0] + sums[1]) + (sums[2] + sums[3])) * EARTH_RADIUS;
+}
+
+double ComputeRouteLengthScalar(const SpherePoint* points, const uint32_t* route, size_t size) {
+    double sums[4] = {0, 0, 0, 0};
+    return FinishRouteLength(points, route, size, 0, sums);
+}
+
+#if defined(__x86_64__)
+
+// Собирает координаты четырёх точек по их номерам
+__attribute__((target("avx2")))
+void GatherPoints(const SpherePoint* points, const uint32_t* ids, __m256d& x, __m256d& y, __m256d& z) {
+    const double* base = &points->x;
+    const __m256i index = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ids)));
+    // В SpherePoint три double подряд, смещение точки — 3 * id
+    const __m256i offset = _mm256_add_epi64(_mm256_slli_epi64(index, 1), index);
+    x = _mm256_i64gather_pd(base, offset, 8);
+    y = _mm256_i64gather_pd(base + 1, offset, 8);
+    z = _mm256_i64gather_pd(base + 2, offset, 8);
+}
+
+__attribute__((target("avx2")))
+double ComputeRouteLengthAvx2(const SpherePoint* points, const uint32_t* route, size_t size) {
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d two = _mm256_set1_pd(2);
+    const __m256d small = _mm256_set1_pd(SMALL_HALF_CHORD);
+    const __m256d c3 = _mm256_set1_pd(1.0 / 6);
+    const __m256d c5 = _mm256_set1_pd(3.0 / 40);
+    const __m256d c7 = _mm256_set1_pd(5.0 / 112);
+    const __m256d c9 = _mm256_set1_pd(35.0 / 1152);
+
+    __m256d sums = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 < size; i += 4) {
+        __m256d from_x, from_y, from_z, to_x, to_y, to_z;
+        GatherPoints(points, route + i, from_x, from_y, from_z);
+        GatherPoints(points, route + i + 1, to_x, to_y, to_z);
+
+        const __m256d dx = _mm256_sub_pd(from_x, to_x);
+        const __m256d dy = _mm256_sub_pd(from_y, to_y);
+        const __m256d dz = _mm256_sub_pd(from_z, to_z);
+        const __m256d squared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)),
+                                              _mm256_mul_pd(dz, dz));
+        const __m256d half_chord = _mm256_mul_pd(_mm256_sqrt_pd(squared), half);
+
+        __m256d angle;
+        if (_mm256_movemask_pd(_mm256_cmp_pd(half_chord, small, _CMP_LE_OQ)) == 0xF) {
+            const __m256d x2 = _mm256_mul_pd(half_chord, half_chord);
+            __m256d series = _mm256_add_pd(c7, _mm256_mul_pd(x2, c9));
+            series = _mm256_add_pd(c5, _mm256_mul_pd(x2, series));
+            series = _mm256_add_pd(c3, _mm256_mul_pd(x2, series));
+            series = _mm256_add_pd(half_chord, _mm256_mul_pd(_mm256_mul_pd(half_chord, x2), series));
+            angle = _mm256_mul_pd(two, series);
+        } else {
+            // Длинные отрезки редки, их считаем по одному
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, half_chord);
+            for (double& lane : lanes) {
+                lane = HalfChordToAngle(lane);
+            }
+            angle = _mm256_load_pd(lanes);
+        }
+        sums = _mm256_add_pd(sums, angle);
+    }
+
+    double lane_sums[4];
+    _mm256_storeu_pd(lane_sums, sums);
+    return FinishRouteLength(points, route, size, i, lane_sums);
+}
+
+#endif
+
+using RouteLengthKernel = double (*)(const SpherePoint* points, const uint32_t* route, size_t size);
+
+RouteLengthKernel SelectRouteLengthKernel() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return ComputeRouteLengthAvx2;
+    }
+#endif
+    return ComputeRouteLengthScalar;
+}
+
+}  // namespace
+
 double ComputeDistance(Coordinates from, Coordinates to) {
     using namespace std;
     const double dr = M_PI / 180.0;
@@ -15,7 +139,27 @@ double ComputeDistance(Coordinates from, Coordinates to) {
 
     return acos(sin(from.lat * dr) * sin(to.lat * dr)
                 + cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr))
-        * 6371000;
+        * EARTH_RADIUS;
+}
+
+SpherePoint ToSpherePoint(Coordinates coords) {
+    const double dr = M_PI / 180.0;
+    const double lat = coords.lat * dr;
+    const double lng = coords.lng * dr;
+    return {std::cos(lat) * std::cos(lng), std::cos(lat) * std::sin(lng), std::sin(lat)};
+}
+
+double ComputeHaversineDistance(Coordinates from, Coordinates to) {
+    return ComputeHaversineDistance(ToSpherePoint(from), ToSpherePoint(to));
+}
+
+double ComputeHaversineDistance(SpherePoint from, SpherePoint to) {
+    return HalfChordToAngle(HalfChord(from, to)) * EARTH_RADIUS;
+}
+
+double ComputeRouteLength(std::span<const SpherePoint> points, std::span<const uint32_t> route) {
+    static const RouteLengthKernel kernel = SelectRouteLengthKernel();
+    return kernel(points.data(), route.data(), route.size());
 }
 
 bool operator==(const Coordinates &lhs, const Coordinates &rhs) {
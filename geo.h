@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
+
 namespace geo {
 
+// Радиус Земли в метрах, принятый во всех расчётах расстояний
+inline constexpr double EARTH_RADIUS = 6371000;
+
 struct Coordinates {
     double lat; // Широта
     double lng; // Долгота
@@ -13,4 +19,29 @@ bool operator!=(const Coordinates& lhs, const Coordinates& rhs);
 
 double ComputeDistance(Coordinates from, Coordinates to);
 
+// Точка на единичной сфере. Расстояние между такими точками считается без
+// тригонометрии по широте и долготе, поэтому их удобно перевести один раз заранее
+struct SpherePoint {
+    double x = 0;
+    double y = 0;
+    double z = 0;
+};
+
+SpherePoint ToSpherePoint(Coordinates coords);
+
+/*
+ * Расстояние по дуге через длину хорды — то же, что формула гаверсинусов.
+ * ComputeDistance берёт acos от числа, близкого к 1, и на коротких отрезках
+ * ошибается до ~0.15 м, здесь же ошибка относительная, порядка 1e-15.
+ * Результаты двух функций отличаются не больше чем на 0.15 м на любом отрезке;
+ * на отрезках длиннее 100 км — не больше чем на 1e-5 м
+ */
+double ComputeHaversineDistance(Coordinates from, Coordinates to);
+double ComputeHaversineDistance(SpherePoint from, SpherePoint to);
+
+// Длина ломаной points[route[0]] → points[route[1]] → ... в метрах тем же способом,
+// что и ComputeHaversineDistance. Отрезки обрабатываются по четыре с AVX2,
+// если процессор его поддерживает. Результат от набора инструкций не зависит
+double ComputeRouteLength(std::span<const SpherePoint> points, std::span<const uint32_t> route);
+
 }  // namespace geo
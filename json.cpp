@@ -1,49 +1,239 @@
 #include "json.h"
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <iterator>
+#include <type_traits>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace json {
 
 namespace {
 using namespace std::literals;
 
-Node LoadNode(std::istream& input);
-Node LoadString(std::istream& input);
+/*
+ * Поиск байтов, на которых посимвольный разбор должен остановиться:
+ * конца или экранирования внутри строки и первого непробельного символа между токенами.
+ * Блоки по 16 (SSE2) или 32 (AVX2) байта проверяются целиком, хвост буфера — побайтно.
+ * Реализация выбирается один раз при первом обращении по возможностям процессора
+ */
+
+// Пробельные символы в смысле std::isspace для локали "C"
+bool IsSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool IsStringSpecial(char c) {
+    return c == '"' || c == '\\' || c == '\n' || c == '\r';
+}
 
-std::string LoadLiteral(std::istream& input) {
-    std::string s;
-    while (std::isalpha(input.peek())) {
-        s.push_back(static_cast<char>(input.get()));
+const char* FindStringSpecialScalar(const char* pos, const char* end) {
+    while (pos != end && !IsStringSpecial(*pos)) {
+        ++pos;
     }
-    return s;
+    return pos;
 }
 
-Node LoadArray(std::istream& input) {
-    std::vector<Node> result;
+const char* SkipSpacesScalar(const char* pos, const char* end) {
+    while (pos != end && IsSpace(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
 
-    for (char c; input >> c && c != ']';) {
-        if (c != ',') {
-            input.putback(c);
+#if defined(__x86_64__) || defined(__i386__)
+
+// Символы '\t'..'\r' идут подряд, поэтому проверяются одним беззнаковым сравнением:
+// (c - '\t') <= 4 <=> min(c - '\t', 4) == c - '\t'
+
+__attribute__((target("sse2")))
+const char* FindStringSpecialSse2(const char* pos, const char* end) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i line_feed = _mm_set1_epi8('\n');
+    const __m128i carriage_return = _mm_set1_epi8('\r');
+    for (; end - pos >= 16; pos += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        const __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)),
+            _mm_or_si128(_mm_cmpeq_epi8(block, line_feed), _mm_cmpeq_epi8(block, carriage_return)));
+        if (const int mask = _mm_movemask_epi8(special)) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return FindStringSpecialScalar(pos, end);
+}
+
+__attribute__((target("sse2")))
+const char* SkipSpacesSse2(const char* pos, const char* end) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i control_range = _mm_set1_epi8('\r' - '\t');
+    for (; end - pos >= 16; pos += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        const __m128i shifted = _mm_sub_epi8(block, tab);
+        const __m128i is_control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, control_range), shifted);
+        const __m128i is_space = _mm_or_si128(_mm_cmpeq_epi8(block, space), is_control);
+        if (const int mask = _mm_movemask_epi8(is_space) ^ 0xFFFF) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return SkipSpacesScalar(pos, end);
+}
+
+__attribute__((target("avx2")))
+const char* FindStringSpecialAvx2(const char* pos, const char* end) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i line_feed = _mm256_set1_epi8('\n');
+    const __m256i carriage_return = _mm256_set1_epi8('\r');
+    for (; end - pos >= 32; pos += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        const __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, backslash)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, line_feed), _mm256_cmpeq_epi8(block, carriage_return)));
+        if (const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(special))) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return FindStringSpecialSse2(pos, end);
+}
+
+__attribute__((target("avx2")))
+const char* SkipSpacesAvx2(const char* pos, const char* end) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i control_range = _mm256_set1_epi8('\r' - '\t');
+    for (; end - pos >= 32; pos += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        const __m256i shifted = _mm256_sub_epi8(block, tab);
+        const __m256i is_control = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, control_range), shifted);
+        const __m256i is_space = _mm256_or_si256(_mm256_cmpeq_epi8(block, space), is_control);
+        if (const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(is_space))) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return SkipSpacesSse2(pos, end);
+}
+
+#endif
+
+struct Scanner {
+    const char* (*find_string_special)(const char* pos, const char* end);
+    const char* (*skip_spaces)(const char* pos, const char* end);
+};
+
+Scanner SelectScanner() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {FindStringSpecialAvx2, SkipSpacesAvx2};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {FindStringSpecialSse2, SkipSpacesSse2};
+    }
+#endif
+    return {FindStringSpecialScalar, SkipSpacesScalar};
+}
+
+const Scanner& GetScanner() {
+    static const Scanner scanner = SelectScanner();
+    return scanner;
+}
+
+// Позиция разбора внутри непрерывного буфера с JSON-документом
+struct Cursor {
+    const char* pos;
+    const char* end;
+    // Буфер для строк с escape-последовательностями, которые нельзя отдать
+    // обработчику прямо из входных данных
+    std::string scratch;
+
+    bool AtEnd() const {
+        return pos == end;
+    }
+
+    // Возвращает очередной символ, не сдвигая позицию, либо EOF в конце буфера
+    int Peek() const {
+        return AtEnd() ? std::char_traits<char>::eof() : static_cast<unsigned char>(*pos);
+    }
+
+    // Аналог input >> c: пропускает пробельные символы и считывает один символ
+    bool ReadToken(char& c) {
+        // Между токенами чаще всего нет пробелов, поэтому первый символ проверяется сразу
+        if (!AtEnd() && IsSpace(*pos)) {
+            pos = GetScanner().skip_spaces(pos, end);
         }
-        result.push_back(LoadNode(input));
+        if (AtEnd()) {
+            return false;
+        }
+        c = *pos++;
+        return true;
+    }
+
+    void PutBack() {
+        --pos;
+    }
+};
+
+/*
+ * Разбор выполняется рекурсивным спуском, который сообщает о каждом элементе
+ * документа обработчику событий. Обработчик подставляется параметром шаблона:
+ * DOM-загрузчик вызывается напрямую, а пользовательский json::Handler — через виртуальные методы
+ */
+
+template <typename Handler>
+void ParseNode(Cursor& input, Handler& handler);
+
+std::string_view ParseLiteral(Cursor& input) {
+    const char* begin = input.pos;
+    while (std::isalpha(input.Peek())) {
+        ++input.pos;
     }
-    if (!input) {
-        throw ParsingError("Array parsing error"s);
+    return {begin, static_cast<size_t>(input.pos - begin)};
+}
+
+template <typename Handler>
+void ParseArray(Cursor& input, Handler& handler) {
+    handler.StartArray();
+
+    char c;
+    while (input.ReadToken(c)) {
+        if (c == ']') {
+            handler.EndArray();
+            return;
+        }
+        if (c != ',') {
+            input.PutBack();
+        }
+        ParseNode(input, handler);
     }
-    return Node(std::move(result));
+
+    throw ParsingError("Array parsing error"s);
 }
 
-Node LoadDict(std::istream& input) {
-    Dict dict;
+std::string_view ParseString(Cursor& input);
 
-    for (char c; input >> c && c != '}';) {
+template <typename Handler>
+void ParseDict(Cursor& input, Handler& handler) {
+    handler.StartDict();
+
+    char c;
+    while (input.ReadToken(c)) {
+        if (c == '}') {
+            handler.EndDict();
+            return;
+        }
         if (c == '"') {
-            std::string key = LoadString(input).AsString();
-            if (input >> c && c == ':') {
-                if (dict.find(key) != dict.end()) {
-                    throw ParsingError("Duplicate key '"s + key + "' have been found");
-                }
-                dict.emplace(std::move(key), LoadNode(input));
+            std::string_view key = ParseString(input);
+            if (input.ReadToken(c) && c == ':') {
+                handler.Key(key);
+                ParseNode(input, handler);
             } else {
                 throw ParsingError(": is expected but '"s + c + "' has been found"s);
             }
@@ -51,30 +241,43 @@ Node LoadDict(std::istream& input) {
             throw ParsingError(R"(',' is expected but ')"s + c + "' has been found"s);
         }
     }
-    if (!input) {
-        throw ParsingError("Dictionary parsing error"s);
-    }
-    return Node(std::move(dict));
+
+    throw ParsingError("Dictionary parsing error"s);
 }
 
-Node LoadString(std::istream& input) {
-    auto it = std::istreambuf_iterator<char>(input);
-    auto end = std::istreambuf_iterator<char>();
-    std::string s;
+// Возвращает содержимое строки. Строка без escape-последовательностей
+// указывает прямо во входной буфер, иначе — в input.scratch до следующего вызова
+std::string_view ParseString(Cursor& input) {
+    const Scanner& scanner = GetScanner();
+
+    const char* begin = input.pos;
+    const char* special = scanner.find_string_special(begin, input.end);
+    if (special != input.end && *special == '"') {
+        input.pos = special + 1;
+        return {begin, static_cast<size_t>(special - begin)};
+    }
+
+    std::string& s = input.scratch;
+    s.clear();
     while (true) {
-        if (it == end) {
+        // Обычные символы до ближайшего специального копируются одним блоком
+        special = scanner.find_string_special(input.pos, input.end);
+        s.append(input.pos, special);
+        input.pos = special;
+
+        if (input.AtEnd()) {
             throw ParsingError("String parsing error");
         }
-        const char ch = *it;
+        const char ch = *input.pos;
         if (ch == '"') {
-            ++it;
+            ++input.pos;
             break;
         } else if (ch == '\\') {
-            ++it;
-            if (it == end) {
+            ++input.pos;
+            if (input.AtEnd()) {
                 throw ParsingError("String parsing error");
             }
-            const char escaped_char = *(it);
+            const char escaped_char = *input.pos;
             switch (escaped_char) {
                 case 'n':
                     s.push_back('\n');
@@ -94,63 +297,57 @@ Node LoadString(std::istream& input) {
                 default:
                     throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
             }
-        } else if (ch == '\n' || ch == '\r') {
-            throw ParsingError("Unexpected end of line"s);
+            ++input.pos;
         } else {
-            s.push_back(ch);
+            // Остались только символы перевода строки
+            throw ParsingError("Unexpected end of line"s);
         }
-        ++it;
     }
 
-    return Node(std::move(s));
+    return s;
 }
 
-Node LoadBool(std::istream& input) {
-    const auto s = LoadLiteral(input);
+template <typename Handler>
+void ParseBool(Cursor& input, Handler& handler) {
+    const auto s = ParseLiteral(input);
     if (s == "true"sv) {
-        return Node{true};
+        handler.Bool(true);
     } else if (s == "false"sv) {
-        return Node{false};
+        handler.Bool(false);
     } else {
-        throw ParsingError("Failed to parse '"s + s + "' as bool"s);
+        throw ParsingError("Failed to parse '"s + std::string(s) + "' as bool"s);
     }
 }
 
-Node LoadNull(std::istream& input) {
-    if (auto literal = LoadLiteral(input); literal == "null"sv) {
-        return Node{nullptr};
+template <typename Handler>
+void ParseNull(Cursor& input, Handler& handler) {
+    if (auto literal = ParseLiteral(input); literal == "null"sv) {
+        handler.Null();
     } else {
-        throw ParsingError("Failed to parse '"s + literal + "' as null"s);
+        throw ParsingError("Failed to parse '"s + std::string(literal) + "' as null"s);
     }
 }
 
-Node LoadNumber(std::istream& input) {
-    std::string parsed_num;
-
-    // Считывает в parsed_num очередной символ из input
-    auto read_char = [&parsed_num, &input] {
-        parsed_num += static_cast<char>(input.get());
-        if (!input) {
-            throw ParsingError("Failed to read number from stream"s);
-        }
-    };
+template <typename Handler>
+void ParseNumber(Cursor& input, Handler& handler) {
+    const char* begin = input.pos;
 
-    // Считывает одну или более цифр в parsed_num из input
-    auto read_digits = [&input, read_char] {
-        if (!std::isdigit(input.peek())) {
+    // Пропускает одну или более цифр
+    auto read_digits = [&input] {
+        if (!std::isdigit(input.Peek())) {
             throw ParsingError("A digit is expected"s);
         }
-        while (std::isdigit(input.peek())) {
-            read_char();
+        while (std::isdigit(input.Peek())) {
+            ++input.pos;
         }
     };
 
-    if (input.peek() == '-') {
-        read_char();
+    if (input.Peek() == '-') {
+        ++input.pos;
     }
     // Парсим целую часть числа
-    if (input.peek() == '0') {
-        read_char();
+    if (input.Peek() == '0') {
+        ++input.pos;
         // После 0 в JSON не могут идти другие цифры
     } else {
         read_digits();
@@ -158,50 +355,55 @@ Node LoadNumber(std::istream& input) {
 
     bool is_int = true;
     // Парсим дробную часть числа
-    if (input.peek() == '.') {
-        read_char();
+    if (input.Peek() == '.') {
+        ++input.pos;
         read_digits();
         is_int = false;
     }
 
     // Парсим экспоненциальную часть числа
-    if (int ch = input.peek(); ch == 'e' || ch == 'E') {
-        read_char();
-        if (ch = input.peek(); ch == '+' || ch == '-') {
-            read_char();
+    if (int ch = input.Peek(); ch == 'e' || ch == 'E') {
+        ++input.pos;
+        if (ch = input.Peek(); ch == '+' || ch == '-') {
+            ++input.pos;
         }
         read_digits();
         is_int = false;
     }
 
-    try {
-        if (is_int) {
-            // Сначала пробуем преобразовать строку в int
-            try {
-                return std::stoi(parsed_num);
-            } catch (...) {
-                // В случае неудачи, например, при переполнении
-                // код ниже попробует преобразовать строку в double
-            }
+    // Число разбирается на месте, без временной строки и исключений
+    if (is_int) {
+        int value;
+        if (auto [ptr, ec] = std::from_chars(begin, input.pos, value); ec == std::errc{}) {
+            handler.Int(value);
+            return;
         }
-        return std::stod(parsed_num);
-    } catch (...) {
-        throw ParsingError("Failed to convert "s + parsed_num + " to number"s);
+        // При переполнении int код ниже попробует преобразовать число в double
     }
+
+    double value;
+    if (auto [ptr, ec] = std::from_chars(begin, input.pos, value); ec != std::errc{}) {
+        throw ParsingError("Failed to convert "s + std::string(begin, input.pos) + " to number"s);
+    }
+    handler.Double(value);
 }
 
-Node LoadNode(std::istream& input) {
+template <typename Handler>
+void ParseNode(Cursor& input, Handler& handler) {
     char c;
-    if (!(input >> c)) {
+    if (!input.ReadToken(c)) {
         throw ParsingError("Unexpected EOF"s);
     }
     switch (c) {
         case '[':
-            return LoadArray(input);
+            ParseArray(input, handler);
+            break;
         case '{':
-            return LoadDict(input);
+            ParseDict(input, handler);
+            break;
         case '"':
-            return LoadString(input);
+            handler.String(ParseString(input));
+            break;
         case 't':
             // Атрибут [[fallthrough]] (провалиться) ничего не делает, и является
             // подсказкой компилятору и человеку, что здесь программист явно задумывал
@@ -211,75 +413,163 @@ Node LoadNode(std::istream& input) {
             // литералов true либо false
             [[fallthrough]];
         case 'f':
-            input.putback(c);
-            return LoadBool(input);
+            input.PutBack();
+            ParseBool(input, handler);
+            break;
         case 'n':
-            input.putback(c);
-            return LoadNull(input);
+            input.PutBack();
+            ParseNull(input, handler);
+            break;
         default:
-            input.putback(c);
-            return LoadNumber(input);
+            input.PutBack();
+            ParseNumber(input, handler);
+            break;
+    }
+}
+
+// Собирает из событий разбора дерево узлов, размещённое в resource
+class DomBuilder {
+public:
+    explicit DomBuilder(std::pmr::memory_resource* resource)
+        : allocator_(resource) {
+    }
+
+    void StartDict() {
+        stack_.push_back(&Add(Dict(allocator_)));
+    }
+
+    void EndDict() {
+        stack_.pop_back();
+    }
+
+    void StartArray() {
+        stack_.push_back(&Add(Array(allocator_)));
     }
+
+    void EndArray() {
+        stack_.pop_back();
+    }
+
+    void Key(std::string_view key) {
+        auto [it, inserted] = stack_.back()->AsDict().try_emplace(std::pmr::string(key, allocator_));
+        if (!inserted) {
+            throw ParsingError("Duplicate key '"s + std::string(key) + "' have been found");
+        }
+        value_slot_ = &it->second;
+    }
+
+    void String(std::string_view value) {
+        Add(std::pmr::string(value, allocator_));
+    }
+
+    void Int(int value) {
+        Add(value);
+    }
+
+    void Double(double value) {
+        Add(value);
+    }
+
+    void Bool(bool value) {
+        Add(value);
+    }
+
+    void Null() {
+        Add(nullptr);
+    }
+
+    Node& GetRoot() {
+        return root_;
+    }
+
+private:
+    // Помещает узел в текущий массив, под последний ключ словаря или в корень
+    Node& Add(Node&& node) {
+        if (stack_.empty()) {
+            root_ = std::move(node);
+            return root_;
+        }
+        if (Node& parent = *stack_.back(); parent.IsArray()) {
+            return parent.AsArray().emplace_back(std::move(node));
+        }
+        *value_slot_ = std::move(node);
+        return *value_slot_;
+    }
+
+    Node::allocator_type allocator_;
+    Node root_;
+    // Открытые массивы и словари. Они не перемещаются в памяти,
+    // пока в них добавляются вложенные узлы
+    std::vector<Node*> stack_;
+    Node* value_slot_ = nullptr;
+};
+
+Node LoadNode(std::string_view input, std::pmr::memory_resource* resource) {
+    Cursor cursor{input.data(), input.data() + input.size(), {}};
+    DomBuilder builder(resource);
+    ParseNode(cursor, builder);
+    return std::move(builder.GetRoot());
+}
+
+// Считывает поток целиком крупными блоками, а не посимвольно
+std::string ReadAll(std::istream& input) {
+    std::string result;
+    char block[64 * 1024];
+    while (input.read(block, sizeof(block)) || input.gcount() > 0) {
+        result.append(block, static_cast<size_t>(input.gcount()));
+    }
+    return result;
 }
 
 struct PrintContext {
-    std::ostream& out;
+    OutputBuffer& out;
+    PrintStyle style = PrintStyle::PRETTY;
+    format::Precision precision = format::Precision::Shortest();
     int indent_step = 4;
     int indent = 0;
 
     void PrintIndent() const {
-        for (int i = 0; i < indent; ++i) {
-            out.put(' ');
+        if (style == PrintStyle::PRETTY) {
+            out.Append(static_cast<size_t>(indent), ' ');
+        }
+    }
+
+    void PrintLineBreak() const {
+        if (style == PrintStyle::PRETTY) {
+            out.Append('\n');
         }
     }
 
     PrintContext Indented() const {
-        return {out, indent_step, indent_step + indent};
+        return {out, style, precision, indent_step, indent_step + indent};
     }
 };
 
 void PrintNode(const Node& value, const PrintContext& ctx);
 
 template <typename Value>
-void PrintValue(const Value& value, const PrintContext& ctx) {
-    ctx.out << value;
+void PrintValue(const Value& value, const PrintContext& ctx);
+
+template <>
+void PrintValue<int>(const int& value, const PrintContext& ctx) {
+    char buffer[16];
+    const auto [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    ctx.out.Append(std::string_view(buffer, end - buffer));
 }
 
-void PrintString(const std::string& value, std::ostream& out) {
-    out.put('"');
-    for (const char c : value) {
-        switch (c) {
-            case '\r':
-                out << "\\r"sv;
-                break;
-            case '\n':
-                out << "\\n"sv;
-                break;
-            case '\t':
-                out << "\\t"sv;
-                break;
-            case '"':
-                // Символы " и \ выводятся как \" или \\, соответственно
-                [[fallthrough]];
-            case '\\':
-                out.put('\\');
-                [[fallthrough]];
-            default:
-                out.put(c);
-                break;
-        }
-    }
-    out.put('"');
+template <>
+void PrintValue<double>(const double& value, const PrintContext& ctx) {
+    ctx.out.Append(format::FormattedDouble(value, ctx.precision).View());
 }
 
 template <>
-void PrintValue<std::string>(const std::string& value, const PrintContext& ctx) {
+void PrintValue<std::pmr::string>(const std::pmr::string& value, const PrintContext& ctx) {
     PrintString(value, ctx.out);
 }
 
 template <>
 void PrintValue<std::nullptr_t>(const std::nullptr_t&, const PrintContext& ctx) {
-    ctx.out << "null"sv;
+    ctx.out.Append("null"sv);
 }
 
 // В специализации шаблона PrintValue для типа bool параметр value передаётся
@@ -288,49 +578,53 @@ void PrintValue<std::nullptr_t>(const std::nullptr_t&, const PrintContext& ctx)
 // void PrintValue(bool value, const PrintContext& ctx);
 template <>
 void PrintValue<bool>(const bool& value, const PrintContext& ctx) {
-    ctx.out << (value ? "true"sv : "false"sv);
+    ctx.out.Append(value ? "true"sv : "false"sv);
 }
 
 template <>
 void PrintValue<Array>(const Array& nodes, const PrintContext& ctx) {
-    std::ostream& out = ctx.out;
-    out << "[\n"sv;
+    OutputBuffer& out = ctx.out;
+    out.Append('[');
+    ctx.PrintLineBreak();
     bool first = true;
     auto inner_ctx = ctx.Indented();
     for (const Node& node : nodes) {
         if (first) {
             first = false;
         } else {
-            out << ",\n"sv;
+            out.Append(',');
+            ctx.PrintLineBreak();
         }
         inner_ctx.PrintIndent();
         PrintNode(node, inner_ctx);
     }
-    out.put('\n');
+    ctx.PrintLineBreak();
     ctx.PrintIndent();
-    out.put(']');
+    out.Append(']');
 }
 
 template <>
 void PrintValue<Dict>(const Dict& nodes, const PrintContext& ctx) {
-    std::ostream& out = ctx.out;
-    out << "{\n"sv;
+    OutputBuffer& out = ctx.out;
+    out.Append('{');
+    ctx.PrintLineBreak();
     bool first = true;
     auto inner_ctx = ctx.Indented();
     for (const auto& [key, node] : nodes) {
         if (first) {
             first = false;
         } else {
-            out << ",\n"sv;
+            out.Append(',');
+            ctx.PrintLineBreak();
         }
         inner_ctx.PrintIndent();
         PrintString(key, ctx.out);
-        out << ": "sv;
+        out.Append(ctx.style == PrintStyle::PRETTY ? ": "sv : ":"sv);
         PrintNode(node, inner_ctx);
     }
-    out.put('\n');
+    ctx.PrintLineBreak();
     ctx.PrintIndent();
-    out.put('}');
+    out.Append('}');
 }
 
 void PrintNode(const Node& node, const PrintContext& ctx) {
@@ -341,14 +635,124 @@ void PrintNode(const Node& node, const PrintContext& ctx) {
         node.GetValue());
 }
 
+// Копирует или перемещает значение узла так, чтобы его содержимое
+// разместилось в ресурсе памяти alloc
+template <typename Value>
+Node WithAllocator(Value&& value, const Node::allocator_type& alloc) {
+    using Type = std::remove_cvref_t<Value>;
+    if constexpr (std::is_same_v<Type, Array> || std::is_same_v<Type, Dict>
+                  || std::is_same_v<Type, std::pmr::string>) {
+        return Type(std::forward<Value>(value), alloc);
+    } else {
+        return value;
+    }
+}
+
 }  // namespace
 
-Document Load(std::istream& input) {
-    return Document{LoadNode(input)};
+OutputBuffer::OutputBuffer(std::ostream& output, size_t capacity)
+    : output_(output),
+      capacity_(capacity) {
+    buffer_.reserve(capacity_);
+}
+
+OutputBuffer::~OutputBuffer() {
+    Flush();
+}
+
+void OutputBuffer::Flush() {
+    output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+void OutputBuffer::FlushIfFull() {
+    if (buffer_.size() >= capacity_) {
+        Flush();
+    }
+}
+
+void PrintString(std::string_view value, OutputBuffer& out) {
+    out.Append('"');
+    // Символы без экранирования выводятся одним блоком
+    size_t run_begin = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        std::string_view escaped;
+        switch (value[i]) {
+            case '\r':
+                escaped = "\\r"sv;
+                break;
+            case '\n':
+                escaped = "\\n"sv;
+                break;
+            case '\t':
+                escaped = "\\t"sv;
+                break;
+            // Символы " и \ выводятся как \" или \\, соответственно
+            case '"':
+                escaped = "\\\""sv;
+                break;
+            case '\\':
+                escaped = "\\\\"sv;
+                break;
+            default:
+                continue;
+        }
+        out.Append(value.substr(run_begin, i - run_begin));
+        out.Append(escaped);
+        run_begin = i + 1;
+    }
+    out.Append(value.substr(run_begin));
+    out.Append('"');
+}
+
+Node::Node(const Node& other, const allocator_type& alloc)
+    : Node(std::visit(
+          [&alloc](const auto& value) {
+              return WithAllocator(value, alloc);
+          },
+          other.GetValue())) {
+}
+
+Node::Node(Node&& other, const allocator_type& alloc)
+    : Node(std::visit(
+          [&alloc](auto&& value) {
+              return WithAllocator(std::move(value), alloc);
+          },
+          static_cast<Value&&>(other))) {
+}
+
+Document Load(std::istream& input, NodeStorage storage) {
+    return Load(std::string_view{ReadAll(input)}, storage);
+}
+
+Document Load(std::string_view input, NodeStorage storage) {
+    if (storage == NodeStorage::HEAP) {
+        return Document{LoadNode(input, std::pmr::get_default_resource())};
+    }
+
+    // Узлы дерева обычно занимают в памяти больше места, чем их текст,
+    // поэтому первый блок арены сразу берётся размером со входные данные
+    auto arena = std::make_shared<std::pmr::monotonic_buffer_resource>(std::max<size_t>(input.size(), 4096));
+    const Node* root = std::pmr::polymorphic_allocator<Node>(arena.get()).new_object<Node>(LoadNode(input, arena.get()));
+    return Document{std::move(arena), root};
+}
+
+void Parse(std::istream& input, Handler& handler) {
+    Parse(std::string_view{ReadAll(input)}, handler);
+}
+
+void Parse(std::string_view input, Handler& handler) {
+    Cursor cursor{input.data(), input.data() + input.size(), {}};
+    ParseNode(cursor, handler);
+}
+
+void Print(const Document& doc, std::ostream& output, PrintStyle style, format::Precision precision) {
+    OutputBuffer buffer(output);
+    PrintNode(doc.GetRoot(), PrintContext{buffer, style, precision});
 }
 
-void Print(const Document& doc, std::ostream& output) {
-    PrintNode(doc.GetRoot(), PrintContext{output});
+void Print(const Node& node, OutputBuffer& output, PrintStyle style, format::Precision precision, int indent) {
+    PrintNode(node, PrintContext{output, style, precision, 4, indent});
 }
 
 }  // namespace json
\ No newline at end of file
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "double_format.h"
+
 #include <iostream>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -10,8 +15,10 @@
 namespace json {
 
 class Node;
-using Dict = std::map<std::string, Node>;
-using Array = std::vector<Node>;
+// Контейнеры узлов берут память из std::pmr::memory_resource, переданного при создании.
+// По умолчанию это обычная куча, но дерево документа можно целиком разместить в арене
+using Dict = std::pmr::map<std::pmr::string, Node>;
+using Array = std::pmr::vector<Node>;
 
 class ParsingError : public std::runtime_error {
 public:
@@ -19,11 +26,33 @@ public:
 };
 
 class Node final
-    : private std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::string> {
+    : private std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::pmr::string> {
 public:
     using variant::variant;
     using Value = variant;
 
+    // Благодаря allocator_type pmr-контейнеры передают свой ресурс памяти
+    // вложенным узлам при копировании, перемещении и вставке
+    using allocator_type = std::pmr::polymorphic_allocator<Node>;
+
+    Node() = default;
+    Node(const Node&) = default;
+    Node(Node&&) = default;
+    Node& operator=(const Node&) = default;
+    Node& operator=(Node&&) = default;
+
+    explicit Node(const allocator_type&) {
+    }
+    Node(const Node& other, const allocator_type& alloc);
+    Node(Node&& other, const allocator_type& alloc);
+
+    Node(std::string_view value)
+        : variant(std::in_place_type<std::pmr::string>, value) {
+    }
+    Node(const std::string& value)
+        : Node(std::string_view{value}) {
+    }
+
     bool IsInt() const {
         return std::holds_alternative<int>(*this);
     }
@@ -83,20 +112,20 @@ public:
     }
 
     bool IsString() const {
-        return std::holds_alternative<std::string>(*this);
+        return std::holds_alternative<std::pmr::string>(*this);
     }
 
-    const std::string& AsString() const {
+    const std::pmr::string& AsString() const {
         using namespace std::literals;
         if (!IsString()) {
             throw std::logic_error("Not a string"s);
         }
 
-        return std::get<std::string>(*this);
+        return std::get<std::pmr::string>(*this);
     }
 
-    std::string& AsString() {
-        return const_cast<std::string&>(std::as_const(*this).AsString());
+    std::pmr::string& AsString() {
+        return const_cast<std::pmr::string&>(std::as_const(*this).AsString());
     }
 
     bool IsDict() const {
@@ -132,15 +161,21 @@ inline bool operator!=(const Node& lhs, const Node& rhs) {
 class Document {
 public:
     explicit Document(Node root)
-        : root_(std::move(root)) {
+        : root_(std::make_shared<const Node>(std::move(root))) {
+    }
+
+    // Корень и все узлы документа размещены в arena. Деструкторы узлов не вызываются,
+    // вся память освобождается разом вместе с ареной
+    Document(std::shared_ptr<std::pmr::monotonic_buffer_resource> arena, const Node* root)
+        : root_(std::move(arena), root) {
     }
 
     const Node& GetRoot() const {
-        return root_;
+        return *root_;
     }
 
 private:
-    Node root_;
+    std::shared_ptr<const Node> root_;
 };
 
 inline bool operator==(const Document& lhs, const Document& rhs) {
@@ -151,8 +186,107 @@ inline bool operator!=(const Document& lhs, const Document& rhs) {
     return !(lhs == rhs);
 }
 
-Document Load(std::istream& input);
+// Способ размещения узлов загружаемого документа
+enum class NodeStorage {
+    // Каждый контейнер и строка выделяются в куче по отдельности
+    HEAP,
+    // Все узлы выделяются в одной монотонной арене, которой владеет документ
+    ARENA,
+};
+
+/*
+ * Считывает поток до конца в строку и разбирает её как Load(std::string_view).
+ * В отличие от посимвольного разбора, чтение не останавливается на конце первого
+ * значения: всё, что записано в потоке после него, считывается и отбрасывается,
+ * а на время разбора в памяти лежит копия всего ввода. Если поток нужно читать
+ * дальше, значение следует выделить из него самостоятельно
+ */
+Document Load(std::istream& input, NodeStorage storage = NodeStorage::HEAP);
+
+// Разбирает JSON-документ, целиком находящийся в памяти
+Document Load(std::string_view input, NodeStorage storage = NodeStorage::HEAP);
+
+/*
+ * Получатель событий потокового разбора json::Parse.
+ * Строки передаются как string_view, действительные только до возврата из обработчика
+ */
+class Handler {
+public:
+    virtual void StartDict() = 0;
+    virtual void EndDict() = 0;
+    virtual void StartArray() = 0;
+    virtual void EndArray() = 0;
+    virtual void Key(std::string_view key) = 0;
+    virtual void String(std::string_view value) = 0;
+    virtual void Int(int value) = 0;
+    virtual void Double(double value) = 0;
+    virtual void Bool(bool value) = 0;
+    virtual void Null() = 0;
+
+    virtual ~Handler() = default;
+};
+
+// Разбирает документ, не строя дерево узлов: каждый элемент сразу передаётся handler.
+// Повторяющиеся ключи словаря не проверяются — это задача обработчика.
+// Поток, как и в Load, считывается до конца
+void Parse(std::istream& input, Handler& handler);
+void Parse(std::string_view input, Handler& handler);
+
+enum class PrintStyle {
+    // Каждый элемент с новой строки, отступ вложенных элементов — 4 пробела
+    PRETTY,
+    // Без пробельных символов между элементами
+    COMPACT,
+};
+
+/*
+ * Накапливает выводимый текст в непрерывном буфере и передаёт его в поток
+ * крупными блоками по мере заполнения и в деструкторе
+ */
+class OutputBuffer {
+public:
+    explicit OutputBuffer(std::ostream& output, size_t capacity = 64 * 1024);
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    ~OutputBuffer();
+
+    void Append(std::string_view text) {
+        buffer_.append(text);
+        FlushIfFull();
+    }
+
+    void Append(char c) {
+        buffer_.push_back(c);
+        FlushIfFull();
+    }
+
+    void Append(size_t count, char c) {
+        buffer_.append(count, c);
+        FlushIfFull();
+    }
+
+    // Передаёт накопленный текст в поток
+    void Flush();
+
+private:
+    void FlushIfFull();
+
+    std::ostream& output_;
+    size_t capacity_;
+    std::string buffer_;
+};
+
+// По умолчанию числа double выводятся в кратчайшей записи без потери точности
+void Print(const Document& doc, std::ostream& output, PrintStyle style = PrintStyle::PRETTY,
+           format::Precision precision = format::Precision::Shortest());
+
+// Выводит узел так, как он выглядел бы внутри документа на уровне отступа indent.
+// Используется для поэлементного вывода в json::Writer
+void Print(const Node& node, OutputBuffer& output, PrintStyle style, format::Precision precision, int indent);
 
-void Print(const Document& doc, std::ostream& output);
+// Выводит строку в кавычках, экранируя специальные символы
+void PrintString(std::string_view value, OutputBuffer& output);
 
 }  // namespace json
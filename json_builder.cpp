@@ -2,29 +2,24 @@
 
 namespace json {
 
-json::Builder& json::Builder::Value(const json::Node& value) {
-    if(root_ == nullptr) {
-        root_ = value;
-    } else if (!stack_.empty() && stack_.top()->IsArray()) {
-        Array& array = stack_.top()->AsArray();
-        array.insert(array.end(), value);
-    } else if (!stack_.empty() && stack_.top()->IsDict() && current_key_) {
+Builder::Builder(std::pmr::memory_resource* resource)
+    : allocator_(resource) {}
 
-        Dict& dict = stack_.top()->AsDict();
-        dict.at(current_key_.value()) = value;
-        current_key_= std::nullopt;
-    } else {
+Builder& Builder::Value(const json::Node& value) {
+    return Value(Node(value, allocator_));
+}
+
+Builder& Builder::Value(json::Node&& value) {
+    if (!Emplace(std::move(value))) {
         throw std::logic_error("Can't put value here");
     }
 
     return *this;
 }
 
-Builder& Builder::Key(const std::string& key) {
+Builder& Builder::Key(std::string_view key) {
     if (!stack_.empty() && stack_.top()->IsDict() && !current_key_) {
-         Dict& dict = stack_.top()->AsDict();
-         dict[key] = nullptr;
-         current_key_ = key;
+         current_key_.emplace(key, allocator_);
     } else {
         throw std::logic_error("Can't put key here");
     }
@@ -33,9 +28,11 @@ Builder& Builder::Key(const std::string& key) {
 }
 
 Builder::DictRef Builder::StartDict() {
-    if(!PushToStack(Dict{})) {
+    Node* dict = Emplace(Dict{allocator_});
+    if (!dict) {
         throw std::logic_error("Can't put array here");
     }
+    stack_.push(dict);
 
     return *this;
 }
@@ -51,9 +48,11 @@ Builder &Builder::EndDict() {
 }
 
 Builder::ArrayRef Builder::StartArray() {
-    if(!PushToStack(Array{})) {
+    Node* array = Emplace(Array{allocator_});
+    if (!array) {
         throw std::logic_error("Can't put array here");
     }
+    stack_.push(array);
 
     return *this;
 }
@@ -73,34 +72,31 @@ Node Builder::Build() {
         throw std::logic_error("Json document is not completed");
     }
 
-    return root_;
+    return std::move(root_);
 }
 
-bool Builder::PushToStack(const Node& node)
+Node* Builder::Emplace(Node&& node)
 {
     if(root_ == nullptr) {
-        root_ = node;
-        stack_.push(&root_);
+        root_ = Node(std::move(node), allocator_);
+        return &root_;
     } else if (!stack_.empty() && stack_.top()->IsArray()) {
         Array& array = stack_.top()->AsArray();
-        auto array_node = array.insert(array.end(), node);
-        stack_.push(array_node.base());
+        return &array.emplace_back(std::move(node));
     } else if (!stack_.empty() && stack_.top()->IsDict() && current_key_) {
         Dict& dict = stack_.top()->AsDict();
-        dict.at(current_key_.value()) = node;
-        stack_.push(&dict.at(current_key_.value()));
+        auto [it, inserted] = dict.insert_or_assign(std::move(*current_key_), std::move(node));
         current_key_= std::nullopt;
-    } else {
-        return false;
+        return &it->second;
     }
 
-    return true;
+    return nullptr;
 }
 
 Builder::DictRef::DictRef(Builder &builder)
     : builder_(builder) {}
 
-Builder::KeyRef Builder::DictRef::Key(const std::string &key) {
+Builder::KeyRef Builder::DictRef::Key(std::string_view key) {
     return builder_.Key(key);
 }
 
@@ -119,6 +115,10 @@ Builder::DictRef Builder::KeyRef::Value(const Node &value) {
     return builder_.Value(value);
 }
 
+Builder::DictRef Builder::KeyRef::Value(Node &&value) {
+    return builder_.Value(std::move(value));
+}
+
 Builder::Builder::DictRef Builder::KeyRef::StartDict() {
     return builder_.StartDict();
 }
@@ -130,6 +130,10 @@ Builder::ArrayRef Builder::ArrayRef::Value(const Node &value) {
     return builder_.Value(value);
 }
 
+Builder::ArrayRef Builder::ArrayRef::Value(Node &&value) {
+    return builder_.Value(std::move(value));
+}
+
 Builder::ArrayRef Builder::ArrayRef::StartArray() {
     return builder_.StartArray();
 }
@@ -3,6 +3,7 @@
 #include <stack>
 #include "json.h"
 #include <optional>
+#include <string_view>
 
 namespace json {
 
@@ -15,7 +16,7 @@ public:
     public:
         DictRef(Builder& builder);
 
-        KeyRef Key(const std::string& key);
+        KeyRef Key(std::string_view key);
         Builder& EndDict();
     private:
         Builder& builder_;
@@ -26,6 +27,7 @@ public:
         KeyRef(Builder& builder);
 
         DictRef Value(const json::Node& value);
+        DictRef Value(json::Node&& value);
         DictRef StartDict();
         ArrayRef StartArray();
     private:
@@ -37,6 +39,7 @@ public:
         ArrayRef(Builder& builder);
 
         ArrayRef Value(const json::Node& value);
+        ArrayRef Value(json::Node&& value);
         ArrayRef StartArray();
         DictRef StartDict();
         Builder& EndArray();
@@ -44,19 +47,28 @@ public:
         Builder& builder_;
     };
 
+    // Все контейнеры и строки строящегося документа выделяются из resource
+    explicit Builder(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Копирует value в ресурс памяти документа
     Builder& Value(const json::Node& value);
-    Builder& Key(const std::string& key);
+    // Перемещает value в документ без копирования, если его содержимое
+    // размещено в том же ресурсе памяти
+    Builder& Value(json::Node&& value);
+    Builder& Key(std::string_view key);
     DictRef StartDict();
     Builder& EndDict();
     ArrayRef StartArray();
     Builder& EndArray();
     json::Node Build();
 private:
-    bool PushToStack(const json::Node& node);
+    // Размещает узел в текущей позиции документа, возвращает nullptr, если это невозможно
+    Node* Emplace(json::Node&& node);
 
+    Node::allocator_type allocator_;
     json::Node root_ = nullptr;
     std::stack<Node*> stack_;
-    std::optional<std::string> current_key_;
+    std::optional<std::pmr::string> current_key_;
 };
 
 }
@@ -1,59 +1,321 @@
 #include "json_reader.h"
 #include "json_builder.h"
+#include "json_writer.h"
+#include <algorithm>
 #include <cmath>
-#include <set>
 
 namespace transport_catalogue {
 
-JsonReader::JsonReader(TransportCatalogue& catalogue,
-                       RequestHandler &request_hander,
+namespace {
+
+/*
+ * Обработчик событий разбора, который заполняет справочник из base_requests
+ * по мере чтения документа. Остальные разделы верхнего уровня собираются в дерево.
+ * Запросы копятся в компактном виде и добавляются одной версией справочника
+ * после конца base_requests: маршруты и расстояния могут ссылаться на остановки,
+ * описанные ниже, а каждая версия справочника стоит копирования его индексов
+ */
+class CatalogueLoader final : public json::Handler {
+public:
+    explicit CatalogueLoader(RequestHandler& request_hander)
+        : request_hander_(request_hander) {
+    }
+
+    json::Dict TakeSections() {
+        return std::move(sections_);
+    }
+
+    void StartDict() override {
+        if (section_) {
+            section_->StartDict();
+        } else if (in_base_requests_ && depth_ == REQUESTS_DEPTH) {
+            request_ = {};
+        }
+        ++depth_;
+    }
+
+    void EndDict() override {
+        --depth_;
+        if (section_) {
+            section_->EndDict();
+            FinishSection();
+        } else if (in_base_requests_ && depth_ == REQUESTS_DEPTH) {
+            FinishRequest();
+        }
+    }
+
+    void StartArray() override {
+        if (section_) {
+            section_->StartArray();
+        }
+        ++depth_;
+    }
+
+    void EndArray() override {
+        --depth_;
+        if (section_) {
+            section_->EndArray();
+            FinishSection();
+        } else if (in_base_requests_ && depth_ == SECTIONS_DEPTH) {
+            FinishBaseRequests();
+        }
+    }
+
+    void Key(std::string_view key) override {
+        if (section_) {
+            section_->Key(key);
+        } else if (depth_ == SECTIONS_DEPTH) {
+            if (key == "base_requests") {
+                in_base_requests_ = true;
+            } else {
+                section_key_ = key;
+                section_.emplace();
+            }
+        } else if (in_base_requests_ && depth_ == FIELDS_DEPTH) {
+            field_ = key;
+        } else if (in_base_requests_ && depth_ == FIELD_ITEMS_DEPTH && field_ == "road_distances") {
+            request_.distances.emplace_back(key, 0);
+        }
+    }
+
+    void String(std::string_view value) override {
+        if (section_) {
+            AddToSection(json::Node(value));
+        } else if (in_base_requests_ && depth_ == FIELDS_DEPTH) {
+            if (field_ == "type") {
+                request_.type = value;
+            } else if (field_ == "name") {
+                request_.name = value;
+            }
+        } else if (in_base_requests_ && depth_ == FIELD_ITEMS_DEPTH && field_ == "stops") {
+            request_.stops.emplace_back(value);
+        }
+    }
+
+    void Int(int value) override {
+        if (section_) {
+            AddToSection(value);
+        } else {
+            Number(value);
+        }
+    }
+
+    void Double(double value) override {
+        if (section_) {
+            AddToSection(value);
+        } else {
+            Number(value);
+        }
+    }
+
+    void Bool(bool value) override {
+        if (section_) {
+            AddToSection(value);
+        } else if (in_base_requests_ && depth_ == FIELDS_DEPTH && field_ == "is_roundtrip") {
+            request_.is_roundtrip = value;
+        }
+    }
+
+    void Null() override {
+        if (section_) {
+            AddToSection(nullptr);
+        }
+    }
+
+private:
+    // Глубина вложенности: 1 — ключи корневого словаря, 2 — элементы base_requests,
+    // 3 — поля запроса, 4 — элементы road_distances и stops
+    static constexpr int SECTIONS_DEPTH = 1;
+    static constexpr int REQUESTS_DEPTH = 2;
+    static constexpr int FIELDS_DEPTH = 3;
+    static constexpr int FIELD_ITEMS_DEPTH = 4;
+
+    struct BaseRequest {
+        std::string type;
+        std::string name;
+        geo::Coordinates coords{};
+        std::vector<std::pair<std::string, int>> distances;
+        std::vector<std::string> stops;
+        bool is_roundtrip = false;
+    };
+
+    void Number(double value) {
+        if (!in_base_requests_) {
+            return;
+        }
+        if (depth_ == FIELDS_DEPTH) {
+            if (field_ == "latitude") {
+                request_.coords.lat = value;
+            } else if (field_ == "longitude") {
+                request_.coords.lng = value;
+            }
+        } else if (depth_ == FIELD_ITEMS_DEPTH && field_ == "road_distances") {
+            request_.distances.back().second = static_cast<int>(value);
+        }
+    }
+
+    void FinishRequest() {
+        if (request_.type == "Stop") {
+            pending_stops_.push_back({request_.name, request_.coords});
+            if (!request_.distances.empty()) {
+                pending_distances_.push_back(std::move(request_));
+            }
+        } else if (request_.type == "Bus") {
+            pending_buses_.push_back(std::move(request_));
+        }
+    }
+
+    void FinishBaseRequests() {
+        TransportCatalogue::BulkData data;
+        data.stops.reserve(pending_stops_.size());
+        for (const auto& [name, coords] : pending_stops_) {
+            data.stops.push_back({name, coords});
+        }
+        for (const BaseRequest& stop : pending_distances_) {
+            for (const auto& [destination_stop_name, distance] : stop.distances) {
+                data.distances.push_back({stop.name, destination_stop_name, distance});
+            }
+        }
+        for (const BaseRequest& bus : pending_buses_) {
+            data.buses.push_back({bus.name, {bus.stops.begin(), bus.stops.end()}, bus.is_roundtrip});
+        }
+        request_hander_.AddBulk(std::move(data));
+
+        pending_stops_.clear();
+        pending_distances_.clear();
+        pending_buses_.clear();
+        in_base_requests_ = false;
+    }
+
+    void AddToSection(json::Node value) {
+        if (depth_ == SECTIONS_DEPTH) {
+            // Значение раздела — скаляр, строить для него дерево не нужно
+            sections_.insert_or_assign(std::pmr::string(section_key_), std::move(value));
+            section_.reset();
+            return;
+        }
+        section_->Value(std::move(value));
+    }
+
+    // Раздел готов, когда закрыт его внешний контейнер или прочитано скалярное значение
+    void FinishSection() {
+        if (depth_ == SECTIONS_DEPTH) {
+            sections_.insert_or_assign(std::pmr::string(section_key_), section_->Build());
+            section_.reset();
+        }
+    }
+
+    RequestHandler& request_hander_;
+
+    int depth_ = 0;
+    bool in_base_requests_ = false;
+    std::string field_;
+    BaseRequest request_;
+    // Остановка без расстояний занимает только название и координаты
+    std::vector<std::pair<std::string, geo::Coordinates>> pending_stops_;
+    std::vector<BaseRequest> pending_distances_;
+    std::vector<BaseRequest> pending_buses_;
+
+    std::string section_key_;
+    std::optional<json::Builder> section_;
+    json::Dict sections_;
+};
+
+}  // namespace
+
+JsonReader::JsonReader(RequestHandler &request_hander,
                        MapRenderer& renderer,
                        std::istream &input)
-    : catalogue_(catalogue),
-      request_hander_(request_hander),
-      renderer_(renderer)
+    : request_hander_(request_hander),
+      renderer_(renderer),
+      document_(json::Load(input, json::NodeStorage::ARENA)),
+      root_(document_.GetRoot().AsDict())
+{
+}
+
+JsonReader::JsonReader(RequestHandler &request_hander,
+                       MapRenderer& renderer,
+                       std::string_view input,
+                       LoadMode mode)
+    : request_hander_(request_hander),
+      renderer_(renderer),
+      document_(mode == LoadMode::STREAMING ? LoadStreaming(input)
+                                            : json::Load(input, json::NodeStorage::ARENA)),
+      root_(document_.GetRoot().AsDict())
 {
-    json::Document json_doc = json::Load(input);
-    root_ = json_doc.GetRoot().AsDict();
+}
+
+json::Document JsonReader::LoadStreaming(std::string_view input) {
+    CatalogueLoader loader(request_hander_);
+    json::Parse(input, loader);
+    return json::Document{loader.TakeSections()};
 }
 
 void JsonReader::FillCatalogue() {
-    const json::Array& base_requests = root_.at("base_requests").AsArray();
+    auto base_requests_it = root_.find("base_requests");
+    if (base_requests_it == root_.end()) {
+        return;
+    }
+    const json::Array& base_requests = base_requests_it->second.AsArray();
 
-    FillStops(base_requests);
-    FillBuses(base_requests);
+    request_hander_.AddBulk(ReadBaseRequests(base_requests));
 }
 
-void JsonReader::PrintStats(std::ostream& output) {
+void JsonReader::PrintStats(std::ostream& output, json::PrintStyle style, format::Precision precision) {
     const json::Array& stat_requests = root_.at("stat_requests").AsArray();
+    request_hander_.BeginBatch();
+    const TransportCatalogue& catalogue = request_hander_.GetCatalogue();
+    if (root_.contains("routing_settings")) {
+        SetRoutingSettings();
+    }
 
-    json::Builder builder;
-    json::Builder::ArrayRef responces = builder.StartArray();
+    // Каждый ответ выводится сразу, как только готов
+    json::Writer writer(output, style, precision);
+    json::Writer::ArrayRef responces = writer.StartArray();
 
     for (const json::Node& stat_request_node : stat_requests) {
         const json::Dict& stat_request = stat_request_node.AsDict();
 
-        json::Builder::DictRef stat = responces
+        json::Writer::DictRef stat = responces
                 .StartDict()
                     .Key("request_id")
                     .Value(stat_request.at("id").AsInt());
 
         if (stat_request.at("type") == "Stop") {
-            const std::string& stop_name = stat_request.at("name").AsString();
+            std::string_view stop_name = stat_request.at("name").AsString();
             AddStopStats(stat, stop_name);
         } else if (stat_request.at("type") == "Bus") {
-            const std::string& bus_name = stat_request.at("name").AsString();
+            std::string_view bus_name = stat_request.at("name").AsString();
             AddBusStats(stat, bus_name);
         } else if (stat_request.at("type") == "Map") {
             SetRenderSettings();
             AddMap(stat);
+        } else if (stat_request.at("type") == "Route") {
+            AddRoute(stat, stat_request.at("from").AsString(), stat_request.at("to").AsString());
+        } else if (stat_request.at("type") == "Reachable") {
+            AddReachable(stat, stat_request);
+        } else if (stat_request.at("type") == "Matrix") {
+            AddMatrix(stat, stat_request.at("from").AsArray(), stat_request.at("to").AsArray());
+        } else if (stat_request.at("type") == "NearestStops") {
+            geo::Coordinates center{stat_request.at("latitude").AsDouble(), stat_request.at("longitude").AsDouble()};
+            int count = stat_request.at("count").AsInt();
+            AddStopsAround(stat, center, catalogue.FindNearestStops(center, std::max(count, 0)));
+        } else if (stat_request.at("type") == "StopsInRadius") {
+            geo::Coordinates center{stat_request.at("latitude").AsDouble(), stat_request.at("longitude").AsDouble()};
+            double radius = stat_request.at("radius").AsDouble();
+            AddStopsAround(stat, center, catalogue.FindStopsWithinRadius(center, radius));
+        } else if (stat_request.at("type") == "StopsInBox") {
+            geo::Coordinates south_west{stat_request.at("min_latitude").AsDouble(),
+                                        stat_request.at("min_longitude").AsDouble()};
+            geo::Coordinates north_east{stat_request.at("max_latitude").AsDouble(),
+                                        stat_request.at("max_longitude").AsDouble()};
+            AddStopsInBox(stat, south_west, north_east);
         }
 
         stat.EndDict();
     }
 
-    json::Document output_doc{responces.EndArray().Build()};
-    Print(output_doc, output);
+    responces.EndArray().Finish();
 }
 
 void JsonReader::SetRenderSettings() {
@@ -88,70 +350,72 @@ void JsonReader::SetRenderSettings() {
     renderer_.SetSettings(std::move(settings));
 }
 
-void JsonReader::FillStops(const json::Array &base_requests) {
+void JsonReader::SetRoutingSettings() {
+    const json::Dict& routing_settings = root_.at("routing_settings").AsDict();
+
+    RoutingSettings settings;
+    settings.bus_wait_time = routing_settings.at("bus_wait_time").AsDouble();
+    settings.bus_velocity = routing_settings.at("bus_velocity").AsDouble();
+
+    request_hander_.SetRoutingSettings(settings);
+}
+
+TransportCatalogue::BulkData JsonReader::ReadBaseRequests(const json::Array &base_requests) {
+    TransportCatalogue::BulkData data;
+
     for (const json::Node& base_request_node : base_requests) {
         const json::Dict& base_request = base_request_node.AsDict();
+        const json::Node& type = base_request.at("type");
 
-        if (base_request.at("type") == "Stop") {
-            const std::string& stop_name = base_request.at("name").AsString();
+        if (type == "Stop") {
+            std::string_view stop_name = base_request.at("name").AsString();
             double latitude = base_request.at("latitude").AsDouble();
             double longitude = base_request.at("longitude").AsDouble();
+            data.stops.push_back({stop_name, {latitude, longitude}});
 
-            catalogue_.AddStop(stop_name, {latitude, longitude});
-
-            if (base_request.contains("road_distances")) {
-                const json::Dict& road_distances = base_request.at("road_distances").AsDict();
-
-                for (auto& [destination_stop_name, distance_node] : road_distances) {
-                    catalogue_.SetStopsDistance(stop_name, destination_stop_name, distance_node.AsDouble());
+            if (auto road_distances_it = base_request.find("road_distances"); road_distances_it != base_request.end()) {
+                for (auto& [destination_stop_name, distance_node] : road_distances_it->second.AsDict()) {
+                    data.distances.push_back({stop_name, destination_stop_name,
+                                              static_cast<int>(distance_node.AsDouble())});
                 }
             }
-         }
-    }
-}
-
-void JsonReader::FillBuses(const json::Array &base_requests) {
-    for (const json::Node& base_request_node : base_requests) {
-        const json::Dict& base_request = base_request_node.AsDict();
-
-        if (base_request.at("type") == "Bus") {
-            const std::string& bus_name = base_request.at("name").AsString();
+        } else if (type == "Bus") {
+            std::string_view bus_name = base_request.at("name").AsString();
             bool is_roundtrip = base_request.at("is_roundtrip").AsBool();
             const json::Array& stops = base_request.at("stops").AsArray();
 
             std::vector<std::string_view> stops_vec;
+            stops_vec.reserve(stops.size());
             for (const json::Node& stop_name_node : stops) {
                 stops_vec.push_back(stop_name_node.AsString());
             }
-
-            request_hander_.AddBus(bus_name, stops_vec, is_roundtrip);
+            data.buses.push_back({bus_name, std::move(stops_vec), is_roundtrip});
         }
     }
+
+    return data;
 }
 
-void JsonReader::AddStopStats(json::Builder::DictRef stat, const std::string& stop_name) {
-    if(!catalogue_.GetStop(stop_name)) {
+void JsonReader::AddStopStats(json::Writer::DictRef stat, std::string_view stop_name) {
+    const TransportCatalogue& catalogue = request_hander_.GetCatalogue();
+    std::optional<StopId> stop = catalogue.FindStop(stop_name);
+    if(!stop) {
         stat.Key("error_message").Value("not found");
         return;
     }
 
-    json::Builder::ArrayRef buses_array = stat.Key("buses").StartArray();
-
-    std::set<std::string> buses;
-    for (const auto bus_ptr : catalogue_.GetBusesOfStop(stop_name)) {
-        buses.insert(bus_ptr->title);
-    }
+    json::Writer::ArrayRef buses_array = stat.Key("buses").StartArray();
 
-    for (const std::string& bus_title : buses) {
-        buses_array.Value(bus_title);
+    for (BusId bus : catalogue.GetBusesOfStop(*stop)) {
+        buses_array.String(catalogue.GetBus(bus).title);
     }
 
     buses_array.EndArray();
 }
 
-void JsonReader::AddBusStats(json::Builder::DictRef stat, const std::string &bus_name) {
+void JsonReader::AddBusStats(json::Writer::DictRef stat, std::string_view bus_name) {
     BusStats stats;
-    if(auto val = catalogue_.GetBusStats(bus_name)){
+    if(auto val = request_hander_.GetCatalogue().GetBusStats(bus_name)){
         stats = val.value();
     } else {
         stat.Key("error_message").Value("not found");
@@ -164,13 +428,129 @@ void JsonReader::AddBusStats(json::Builder::DictRef stat, const std::string &bus
     stat.Key("unique_stop_count").Value(stats.uniq_stops_amount);
 }
 
-void JsonReader::AddMap(json::Builder::DictRef stat) {
+void JsonReader::AddMap(json::Writer::DictRef stat) {
     stat.Key("map").Value(request_hander_.RenderMap());
 }
 
+void JsonReader::AddRoute(json::Writer::DictRef stat, std::string_view from, std::string_view to) {
+    const std::optional<TransportRouter::Route> route = request_hander_.FindRoute(from, to);
+    if (!route) {
+        stat.Key("error_message").Value("not found");
+        return;
+    }
+
+    const TransportCatalogue& catalogue = request_hander_.GetCatalogue();
+    const double wait_time = request_hander_.GetRoutingSettings().bus_wait_time;
+    stat.Key("total_time").Value(route->total_time);
+
+    json::Writer::ArrayRef items = stat.Key("items").StartArray();
+    for (const TransportRouter::Ride& ride : route->rides) {
+        items
+            .StartDict()
+                .Key("type").String("Wait")
+                .Key("stop_name").String(catalogue.GetStop(ride.from).title)
+                .Key("time").Value(wait_time)
+            .EndDict()
+            .StartDict()
+                .Key("type").String("Bus")
+                .Key("bus").String(catalogue.GetBus(ride.bus).title)
+                .Key("span_count").Value(static_cast<int>(ride.span_count))
+                .Key("time").Value(ride.time)
+            .EndDict();
+    }
+    items.EndArray();
+}
+
+void JsonReader::AddReachable(json::Writer::DictRef stat, const json::Dict& request) {
+    const bool by_time = request.contains("max_time");
+    const TransportRouter::CostType cost_type = by_time ? TransportRouter::CostType::TIME
+                                                        : TransportRouter::CostType::DISTANCE;
+    const double max_cost = request.at(by_time ? "max_time" : "max_distance").AsDouble();
+
+    const auto stops = request_hander_.FindReachable(request.at("from").AsString(), cost_type, max_cost);
+    if (!stops) {
+        stat.Key("error_message").Value("not found");
+        return;
+    }
+
+    const TransportCatalogue& catalogue = request_hander_.GetCatalogue();
+    const std::string_view cost_key = by_time ? "time" : "distance";
+    json::Writer::ArrayRef stops_array = stat.Key("stops").StartArray();
+    for (const TransportRouter::ReachableStop& reachable : *stops) {
+        stops_array
+            .StartDict()
+                .Key("name").String(catalogue.GetStop(reachable.stop).title)
+                .Key(cost_key).Value(reachable.cost)
+            .EndDict();
+    }
+    stops_array.EndArray();
+}
+
+void JsonReader::AddMatrix(json::Writer::DictRef stat, const json::Array& from, const json::Array& to) {
+    auto read_titles = [](const json::Array& titles) {
+        std::vector<std::string_view> result;
+        result.reserve(titles.size());
+        for (const json::Node& title : titles) {
+            result.push_back(title.AsString());
+        }
+        return result;
+    };
+
+    const std::optional<std::vector<double>> matrix = request_hander_.ComputeMatrix(read_titles(from), read_titles(to));
+    if (!matrix) {
+        stat.Key("error_message").Value("not found");
+        return;
+    }
+
+    json::Writer::ArrayRef rows = stat.Key("times").StartArray();
+    for (size_t row = 0; row < from.size(); ++row) {
+        json::Writer::ArrayRef cells = rows.StartArray();
+        for (size_t column = 0; column < to.size(); ++column) {
+            const double time = (*matrix)[row * to.size() + column];
+            cells.Value(std::isinf(time) ? json::Node{} : json::Node{time});
+        }
+        cells.EndArray();
+    }
+    rows.EndArray();
+}
+
+void JsonReader::AddStopsAround(json::Writer::DictRef stat, geo::Coordinates center,
+                                const std::vector<StopId>& stops) {
+    const TransportCatalogue& catalogue = request_hander_.GetCatalogue();
+    json::Writer::ArrayRef stops_array = stat.Key("stops").StartArray();
+
+    for (StopId id : stops) {
+        const Stop stop = catalogue.GetStop(id);
+        stops_array
+            .StartDict()
+                .Key("name").String(stop.title)
+                .Key("distance").Value(geo::ComputeHaversineDistance(center, stop.coords))
+            .EndDict();
+    }
+
+    stops_array.EndArray();
+}
+
+void JsonReader::AddStopsInBox(json::Writer::DictRef stat, geo::Coordinates south_west, geo::Coordinates north_east) {
+    const TransportCatalogue& catalogue = request_hander_.GetCatalogue();
+    std::vector<Stop> stops;
+    for (StopId id : catalogue.FindStopsInBox(south_west, north_east)) {
+        stops.push_back(catalogue.GetStop(id));
+    }
+    std::sort(stops.begin(), stops.end(), [](const Stop& lhs, const Stop& rhs) {
+        return lhs.title < rhs.title;
+    });
+
+    json::Writer::ArrayRef stops_array = stat.Key("stops").StartArray();
+    for (const Stop& stop : stops) {
+        stops_array.String(stop.title);
+    }
+    stops_array.EndArray();
+}
+
 svg::Color JsonReader::ReadColor(const json::Node& color_node) {
     if (color_node.IsString()) {
-        return color_node.AsString();
+        return std::string(color_node.AsString());
     } else if (color_node.IsArray()) {
         json::Array rgb = color_node.AsArray();
         if (rgb.size() == 3) {
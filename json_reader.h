@@ -3,33 +3,61 @@
 #include "transport_catalogue.h"
 #include "request_handler.h"
 #include "map_renderer.h"
-#include "json_builder.h"
+#include "json_writer.h"
 
 namespace transport_catalogue {
 
 class JsonReader {
 public:
-    JsonReader(TransportCatalogue& catalogue,
-               RequestHandler& request_hander,
+    enum class LoadMode {
+        // Документ целиком разбирается в дерево, справочник заполняет FillCatalogue
+        DOCUMENT,
+        // base_requests передаются в справочник прямо во время разбора, дерево строится
+        // только для остальных разделов. FillCatalogue в этом режиме ничего не делает
+        STREAMING,
+    };
+
+    JsonReader(RequestHandler& request_hander,
                MapRenderer& renderer,
                std::istream &input);
 
+    // Разбирает документ прямо из буфера, например из отображённого в память файла
+    JsonReader(RequestHandler& request_hander,
+               MapRenderer& renderer,
+               std::string_view input,
+               LoadMode mode = LoadMode::DOCUMENT);
+
     void FillCatalogue();
-    void PrintStats(std::ostream& output);
+    // Отвечает на stat_requests одной пачкой: все ответы берутся из одного снимка справочника
+    void PrintStats(std::ostream& output, json::PrintStyle style = json::PrintStyle::PRETTY,
+                    format::Precision precision = format::Precision::Shortest());
     void SetRenderSettings();
+    void SetRoutingSettings();
 private:
-    void FillStops(const json::Array& base_requests);
-    void FillBuses(const json::Array& base_requests);
-    void AddStopStats(json::Builder::DictRef stat, const std::string& stop_name);
-    void AddBusStats(json::Builder::DictRef stat, const std::string& bus_name);
-    void AddMap(json::Builder::DictRef stat);
+    json::Document LoadStreaming(std::string_view input);
+    // Остановки, расстояния и маршруты из base_requests. Строки ссылаются на document_
+    TransportCatalogue::BulkData ReadBaseRequests(const json::Array& base_requests);
+    void AddStopStats(json::Writer::DictRef stat, std::string_view stop_name);
+    void AddBusStats(json::Writer::DictRef stat, std::string_view bus_name);
+    void AddMap(json::Writer::DictRef stat);
+    void AddRoute(json::Writer::DictRef stat, std::string_view from, std::string_view to);
+    // Остановки, до которых можно добраться из from не дольше max_time минут или,
+    // если max_time не задан, проехав не больше max_distance метров
+    void AddReachable(json::Writer::DictRef stat, const json::Dict& request);
+    // Матрица времени в пути: строка на каждую остановку from, null — не доехать
+    void AddMatrix(json::Writer::DictRef stat, const json::Array& from, const json::Array& to);
+    // Остановки в порядке, который вернул поиск, с расстоянием до center
+    void AddStopsAround(json::Writer::DictRef stat, geo::Coordinates center, const std::vector<StopId>& stops);
+    void AddStopsInBox(json::Writer::DictRef stat, geo::Coordinates south_west, geo::Coordinates north_east);
 
     svg::Color ReadColor(const json::Node& color_node);
 
-    TransportCatalogue& catalogue_;
     RequestHandler& request_hander_;
     MapRenderer& renderer_;
-    json::Dict root_;
+    // Входной документ размещён в арене и освобождается целиком.
+    // В режиме STREAMING в нём нет раздела base_requests
+    json::Document document_;
+    const json::Dict& root_;
 };
 
 }
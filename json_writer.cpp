@@ -0,0 +1,191 @@
+#include "json_writer.h"
+
+namespace json {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr int INDENT_STEP = 4;
+
+}
+
+Writer::Writer(std::ostream& output, PrintStyle style, format::Precision precision)
+    : output_(output),
+      buffer_(output),
+      style_(style),
+      precision_(precision) {}
+
+Writer& Writer::Value(const Node& value) {
+    BeginValue();
+    Print(value, buffer_, style_, precision_, static_cast<int>(stack_.size()) * INDENT_STEP);
+
+    return *this;
+}
+
+Writer& Writer::String(std::string_view value) {
+    BeginValue();
+    PrintString(value, buffer_);
+
+    return *this;
+}
+
+Writer& Writer::Key(std::string_view key) {
+    if (stack_.empty() || !stack_.back().is_dict || has_key_) {
+        throw std::logic_error("Can't put key here");
+    }
+
+    Frame& dict = stack_.back();
+    if (!dict.empty) {
+        buffer_.Append(',');
+        PrintLineBreak();
+    }
+    dict.empty = false;
+    PrintIndent();
+    PrintString(key, buffer_);
+    buffer_.Append(style_ == PrintStyle::PRETTY ? ": "sv : ":"sv);
+    has_key_ = true;
+
+    return *this;
+}
+
+Writer::DictRef Writer::StartDict() {
+    BeginValue();
+    buffer_.Append('{');
+    PrintLineBreak();
+    stack_.push_back({true});
+
+    return *this;
+}
+
+Writer& Writer::EndDict() {
+    if (stack_.empty() || !stack_.back().is_dict || has_key_) {
+        throw std::logic_error("No dict to close");
+    }
+    EndContainer(true);
+
+    return *this;
+}
+
+Writer::ArrayRef Writer::StartArray() {
+    BeginValue();
+    buffer_.Append('[');
+    PrintLineBreak();
+    stack_.push_back({false});
+
+    return *this;
+}
+
+Writer& Writer::EndArray() {
+    if (stack_.empty() || stack_.back().is_dict) {
+        throw std::logic_error("No array to close");
+    }
+    EndContainer(false);
+
+    return *this;
+}
+
+void Writer::Finish() {
+    if (!has_root_ || !stack_.empty()) {
+        throw std::logic_error("Json document is not completed");
+    }
+    buffer_.Flush();
+    output_.flush();
+}
+
+void Writer::BeginValue() {
+    if (stack_.empty()) {
+        if (has_root_) {
+            throw std::logic_error("Can't put value here");
+        }
+        has_root_ = true;
+    } else if (stack_.back().is_dict) {
+        if (!has_key_) {
+            throw std::logic_error("Can't put value here");
+        }
+        has_key_ = false;
+    } else {
+        Frame& array = stack_.back();
+        if (!array.empty) {
+            buffer_.Append(',');
+            PrintLineBreak();
+        }
+        array.empty = false;
+        PrintIndent();
+    }
+}
+
+void Writer::EndContainer(bool is_dict) {
+    stack_.pop_back();
+    PrintLineBreak();
+    PrintIndent();
+    buffer_.Append(is_dict ? '}' : ']');
+}
+
+// Отступ соответствует текущей глубине вложенности
+void Writer::PrintIndent() {
+    if (style_ == PrintStyle::PRETTY) {
+        buffer_.Append(stack_.size() * INDENT_STEP, ' ');
+    }
+}
+
+void Writer::PrintLineBreak() {
+    if (style_ == PrintStyle::PRETTY) {
+        buffer_.Append('\n');
+    }
+}
+
+Writer::DictRef::DictRef(Writer& writer)
+    : writer_(writer) {}
+
+Writer::KeyRef Writer::DictRef::Key(std::string_view key) {
+    return writer_.Key(key);
+}
+
+Writer& Writer::DictRef::EndDict() {
+    return writer_.EndDict();
+}
+
+Writer::KeyRef::KeyRef(Writer& writer)
+    : writer_(writer) {}
+
+Writer::DictRef Writer::KeyRef::Value(const Node& value) {
+    return writer_.Value(value);
+}
+
+Writer::DictRef Writer::KeyRef::String(std::string_view value) {
+    return writer_.String(value);
+}
+
+Writer::DictRef Writer::KeyRef::StartDict() {
+    return writer_.StartDict();
+}
+
+Writer::ArrayRef Writer::KeyRef::StartArray() {
+    return writer_.StartArray();
+}
+
+Writer::ArrayRef::ArrayRef(Writer& writer)
+    : writer_(writer) {}
+
+Writer::ArrayRef Writer::ArrayRef::Value(const Node& value) {
+    return writer_.Value(value);
+}
+
+Writer::ArrayRef Writer::ArrayRef::String(std::string_view value) {
+    return writer_.String(value);
+}
+
+Writer::ArrayRef Writer::ArrayRef::StartArray() {
+    return writer_.StartArray();
+}
+
+Writer::DictRef Writer::ArrayRef::StartDict() {
+    return writer_.StartDict();
+}
+
+Writer& Writer::ArrayRef::EndArray() {
+    return writer_.EndArray();
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "json.h"
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+/*
+ * Потоковый аналог json::Builder: каждый элемент сразу выводится в поток,
+ * дерево документа в памяти не строится. Результат совпадает с json::Print.
+ * DictRef, KeyRef и ArrayRef ограничивают допустимые вызовы так же, как у Builder
+ */
+class Writer {
+public:
+    class KeyRef;
+    class ArrayRef;
+
+    class DictRef {
+    public:
+        DictRef(Writer& writer);
+
+        KeyRef Key(std::string_view key);
+        Writer& EndDict();
+    private:
+        Writer& writer_;
+    };
+
+    class KeyRef {
+    public:
+        KeyRef(Writer& writer);
+
+        DictRef Value(const json::Node& value);
+        DictRef String(std::string_view value);
+        DictRef StartDict();
+        ArrayRef StartArray();
+    private:
+        Writer& writer_;
+    };
+
+    class ArrayRef {
+    public:
+        ArrayRef(Writer& writer);
+
+        ArrayRef Value(const json::Node& value);
+        ArrayRef String(std::string_view value);
+        ArrayRef StartArray();
+        DictRef StartDict();
+        Writer& EndArray();
+    private:
+        Writer& writer_;
+    };
+
+    explicit Writer(std::ostream& output, PrintStyle style = PrintStyle::PRETTY,
+                    format::Precision precision = format::Precision::Shortest());
+
+    Writer& Value(const json::Node& value);
+    // Выводит строку сразу, не создавая для неё узел
+    Writer& String(std::string_view value);
+    Writer& Key(std::string_view key);
+    DictRef StartDict();
+    Writer& EndDict();
+    ArrayRef StartArray();
+    Writer& EndArray();
+    // Проверяет, что документ завершён, и передаёт остаток буфера в поток
+    void Finish();
+private:
+    struct Frame {
+        bool is_dict = false;
+        bool empty = true;
+    };
+
+    // Выводит разделитель и отступ перед очередным значением
+    void BeginValue();
+    void EndContainer(bool is_dict);
+    void PrintIndent();
+    void PrintLineBreak();
+
+    std::ostream& output_;
+    OutputBuffer buffer_;
+    PrintStyle style_;
+    format::Precision precision_;
+    std::vector<Frame> stack_;
+    bool has_key_ = false;
+    bool has_root_ = false;
+};
+
+}
@@ -1,18 +1,68 @@
 #include "json_reader.h"
-#include "transport_catalogue.h"
+#include "versioned_catalogue.h"
 #include "request_handler.h"
 #include "map_renderer.h"
+#include "mapped_file.h"
 
 #include <iostream>
+#include <sstream>
+#include <optional>
+#include <string>
 
 using namespace transport_catalogue;
 
-int main() {
+// Запуск: cpp-transport_catalogue [--stream] [--compact] [--contract] [--freeze-names] [--router-cache=PATH] [input.json]
+// Без пути к файлу запросы читаются из стандартного ввода,
+// иначе указанный файл отображается в память и разбирается без копирования.
+// С --stream справочник заполняется во время разбора, без дерева base_requests в памяти.
+// С --compact ответы выводятся без пробелов и переносов строк.
+// С --contract для запросов Route строится иерархия сжатия графа.
+// С --freeze-names после загрузки справочник замораживается для поиска по названиям.
+// С --router-cache граф маршрутов загружается из файла PATH, если тот построен по тем же
+// данным, иначе строится и сохраняется в него
+int main(int argc, char* argv[]) {
+    using namespace std::literals;
+
     MapRenderer renderer;
-    TransportCatalogue catalogue;
+    VersionedCatalogue catalogue;
     RequestHandler request_hander(catalogue, renderer);
-    JsonReader reader(catalogue, request_hander, renderer, std::cin);
+
+    JsonReader::LoadMode mode = JsonReader::LoadMode::DOCUMENT;
+    json::PrintStyle style = json::PrintStyle::PRETTY;
+    const char* input_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == "--stream"sv) {
+            mode = JsonReader::LoadMode::STREAMING;
+        } else if (argv[i] == "--compact"sv) {
+            style = json::PrintStyle::COMPACT;
+        } else if (argv[i] == "--contract"sv) {
+            request_hander.UseContractionHierarchy(true);
+        } else if (argv[i] == "--freeze-names"sv) {
+            request_hander.FreezeNamesAfterLoad(true);
+        } else if (std::string_view arg = argv[i]; arg.starts_with("--router-cache="sv)) {
+            request_hander.SetRouterCache(std::string(arg.substr(arg.find('=') + 1)));
+        } else {
+            input_path = argv[i];
+        }
+    }
+
+    // Запросы — единственное, что есть во вводе, поэтому стандартный ввод считывается
+    // до конца одним буфером и разбирается так же, как отображённый в память файл
+    std::optional<io::MappedFile> input_file;
+    std::string stdin_input;
+    std::string_view input;
+    if (input_path) {
+        input_file.emplace(input_path);
+        input = input_file->GetData();
+    } else {
+        std::ostringstream buffer;
+        buffer << std::cin.rdbuf();
+        stdin_input = std::move(buffer).str();
+        input = stdin_input;
+    }
+
+    JsonReader reader(request_hander, renderer, input, mode);
 
     reader.FillCatalogue();
-    reader.PrintStats(std::cout);
+    reader.PrintStats(std::cout, style);
 }
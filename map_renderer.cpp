@@ -79,14 +79,15 @@ void MapRenderer::SetSettings(Settings settings) {
     settings_ = settings;
 }
 
-std::string MapRenderer::Render(const std::vector<const Bus*>& buses,
-                                const std::vector<const Stop*> stops) const {
+std::string MapRenderer::Render(const std::vector<Bus>& buses,
+                                const std::vector<Stop>& stops,
+                                std::span<const geo::Coordinates> stops_coords) const {
 
     svg::Document doc;
-    SphereProjector projector = MakeProjector(buses);
+    SphereProjector projector = MakeProjector(buses, stops_coords);
 
-    RenderBusesLines(doc, buses, projector);
-    RenderBusesTitles(doc, buses, projector);
+    RenderBusesLines(doc, buses, stops_coords, projector);
+    RenderBusesTitles(doc, buses, stops_coords, projector);
     RenderStops(doc, stops, projector);
     RenderStopsTitles(doc, stops, projector);
 
@@ -95,11 +96,12 @@ std::string MapRenderer::Render(const std::vector<const Bus*>& buses,
     return render_result.str();
 }
 
-SphereProjector MapRenderer::MakeProjector(const std::vector<const Bus *>& buses) const {
+SphereProjector MapRenderer::MakeProjector(const std::vector<Bus>& buses,
+                                           std::span<const geo::Coordinates> stops_coords) const {
     std::vector<geo::Coordinates> coords;
-    for (const Bus* bus : buses) {
-        for (const Stop* stop : bus->stops) {
-            coords.push_back(stop->coords);
+    for (const Bus& bus : buses) {
+        for (StopId stop : bus.stops) {
+            coords.push_back(stops_coords[stop]);
         }
     }
 
@@ -107,11 +109,12 @@ SphereProjector MapRenderer::MakeProjector(const std::vector<const Bus *>& buses
 }
 
 void MapRenderer::RenderBusesLines(svg::Document& doc,
-                                   const std::vector<const Bus *> buses,
+                                   const std::vector<Bus>& buses,
+                                   std::span<const geo::Coordinates> stops_coords,
                                    const SphereProjector& projector) const {
     int palette_index = 0;
-    for (const Bus* bus : buses) {
-        if(bus->stops.empty()) {
+    for (const Bus& bus : buses) {
+        if(bus.stops.empty()) {
             continue;
         }
 
@@ -122,8 +125,8 @@ void MapRenderer::RenderBusesLines(svg::Document& doc,
             .SetStrokeLineCap(svg::StrokeLineCap::ROUND)
             .SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 
-        for (const Stop* stop : bus->stops) {
-            line.AddPoint(projector(stop->coords));
+        for (StopId stop : bus.stops) {
+            line.AddPoint(projector(stops_coords[stop]));
         }
 
         if(palette_index == static_cast<int>(settings_.color_palette.size()) - 1) {
@@ -137,19 +140,20 @@ void MapRenderer::RenderBusesLines(svg::Document& doc,
 }
 
 void MapRenderer::RenderBusesTitles(svg::Document &doc,
-                                    const std::vector<const Bus *> buses,
+                                    const std::vector<Bus>& buses,
+                                    std::span<const geo::Coordinates> stops_coords,
                                     const SphereProjector &projector) const {
 
     int palette_index = 0;
-    for (const Bus* bus : buses) {
-        if (bus->stops.empty()) {
+    for (const Bus& bus : buses) {
+        if (bus.stops.empty()) {
             continue;
         }
 
         svg::Text bus_title;
 
-        bus_title.SetData(bus->title)
-                 .SetPosition(projector(bus->stops.front()->coords))
+        bus_title.SetData(std::string(bus.title))
+                 .SetPosition(projector(stops_coords[bus.stops.front()]))
                  .SetOffset({settings_.bus_label_offset.x, settings_.bus_label_offset.y})
                  .SetFontSize(settings_.bus_label_font_size)
                  .SetFontFamily("Verdana")
@@ -174,14 +178,14 @@ void MapRenderer::RenderBusesTitles(svg::Document &doc,
         doc.Add(bus_title_base);
         doc.Add(bus_title);
 
-        const Stop* last = bus->stops.at(bus->stops.size()/2);
+        const StopId last = bus.stops[bus.stops.size()/2];
 
-        if (!bus->is_roundtrip && bus->stops.front()->title != last->title) {
+        if (!bus.is_roundtrip && bus.stops.front() != last) {
             svg::Text bus_title2 = bus_title;
             svg::Text bus_title_base2 = bus_title_base;
 
-            bus_title2.SetPosition(projector(last->coords));
-            bus_title_base2.SetPosition(projector(last->coords));
+            bus_title2.SetPosition(projector(stops_coords[last]));
+            bus_title_base2.SetPosition(projector(stops_coords[last]));
 
             doc.Add(bus_title_base2);
             doc.Add(bus_title2);
@@ -190,12 +194,12 @@ void MapRenderer::RenderBusesTitles(svg::Document &doc,
 }
 
 void MapRenderer::RenderStops(svg::Document &doc,
-                              const std::vector<const Stop*> stops,
+                              const std::vector<Stop>& stops,
                               const SphereProjector &projector) const {
 
-    for (const Stop* stop : stops) {
+    for (const Stop& stop : stops) {
         svg::Circle circle;
-        circle.SetCenter(projector(stop->coords))
+        circle.SetCenter(projector(stop.coords))
               .SetRadius(settings_.stop_radius)
               .SetFillColor("white");
         doc.Add(circle);
@@ -204,14 +208,14 @@ void MapRenderer::RenderStops(svg::Document &doc,
 }
 
 void MapRenderer::RenderStopsTitles(svg::Document &doc,
-                                    const std::vector<const Stop *> stops,
+                                    const std::vector<Stop>& stops,
                                     const SphereProjector &projector) const {
 
-    for (const Stop* stop : stops) {
+    for (const Stop& stop : stops) {
         svg::Text stop_title;
 
-        stop_title.SetData(stop->title)
-                 .SetPosition(projector(stop->coords))
+        stop_title.SetData(std::string(stop.title))
+                 .SetPosition(projector(stop.coords))
                  .SetOffset({settings_.stop_label_offset.x, settings_.stop_label_offset.y})
                  .SetFontSize(settings_.stop_label_font_size)
                  .SetFontFamily("Verdana");
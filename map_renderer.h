@@ -31,24 +31,29 @@ public:
     };
 
     void SetSettings(Settings settings);
-    std::string Render(const std::vector<const Bus*>& buses, const std::vector<const Stop*> stops) const;
+    // stops_coords — координаты всех остановок справочника, индекс — StopId
+    std::string Render(const std::vector<Bus>& buses, const std::vector<Stop>& stops,
+                       std::span<const geo::Coordinates> stops_coords) const;
 private:
-    SphereProjector MakeProjector(const std::vector<const Bus*>& buses) const;
+    SphereProjector MakeProjector(const std::vector<Bus>& buses,
+                                  std::span<const geo::Coordinates> stops_coords) const;
 
     void RenderBusesLines(svg::Document& doc,
-                          const std::vector<const Bus*> buses,
+                          const std::vector<Bus>& buses,
+                          std::span<const geo::Coordinates> stops_coords,
                           const SphereProjector& projector) const;
 
     void RenderBusesTitles(svg::Document& doc,
-                           const std::vector<const Bus*> buses,
+                           const std::vector<Bus>& buses,
+                           std::span<const geo::Coordinates> stops_coords,
                            const SphereProjector& projector) const;
 
     void RenderStops(svg::Document& doc,
-                     const std::vector<const Stop*> stops,
+                     const std::vector<Stop>& stops,
                      const SphereProjector& projector) const;
 
     void RenderStopsTitles(svg::Document& doc,
-                           const std::vector<const Stop*> stops,
+                           const std::vector<Stop>& stops,
                            const SphereProjector& projector) const;
 
     Settings settings_;
@@ -0,0 +1,74 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace io {
+
+using namespace std::literals;
+
+MappedFile::MappedFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Can't open "s + path + ": "s + std::strerror(errno));
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        const int error = errno;
+        close(fd);
+        throw std::runtime_error("Can't stat "s + path + ": "s + std::strerror(error));
+    }
+
+    size_ = static_cast<size_t>(file_stat.st_size);
+    // Пустой файл отобразить нельзя, для него GetData() вернёт пустую строку
+    if (size_ > 0) {
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            const int error = errno;
+            close(fd);
+            throw std::runtime_error("Can't map "s + path + ": "s + std::strerror(error));
+        }
+        // Файл читается один раз от начала до конца
+        madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+    }
+
+    // Отображение остаётся действительным и после закрытия дескриптора
+    close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    Unmap();
+}
+
+void MappedFile::Unmap() {
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+}  // namespace io
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace io {
+
+/*
+ * Отображает файл в память только для чтения.
+ * Содержимое доступно через GetData() без промежуточного копирования,
+ * отображение снимается в деструкторе
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    ~MappedFile();
+
+    std::string_view GetData() const {
+        return {data_, size_};
+    }
+
+private:
+    void Unmap();
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace io
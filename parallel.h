@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace transport_catalogue {
+
+// Число потоков по умолчанию — по числу ядер, но не меньше одного
+inline unsigned GetDefaultThreadCount() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// Выполняет function(part) для part от 0 до parts - 1, каждую часть в своём потоке.
+// Исключение из любой части передаётся вызывающему после завершения всех частей
+template <typename Function>
+void RunParallel(unsigned parts, Function function) {
+    std::vector<std::exception_ptr> errors(parts);
+    std::vector<std::thread> workers;
+    workers.reserve(parts);
+
+    auto run_part = [&function, &errors](unsigned part) {
+        try {
+            function(part);
+        } catch (...) {
+            errors[part] = std::current_exception();
+        }
+    };
+
+    for (unsigned part = 1; part < parts; ++part) {
+        workers.emplace_back(run_part, part);
+    }
+    run_part(0);
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// Границы части part при делении count элементов на parts почти равных частей
+inline std::pair<size_t, size_t> PartRange(size_t count, unsigned parts, unsigned part) {
+    return {count * part / parts, count * (part + 1) / parts};
+}
+
+}
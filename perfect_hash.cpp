@@ -0,0 +1,184 @@
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace transport_catalogue {
+
+namespace {
+
+// Финальный шаг splitmix64
+uint64_t Mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+// Старшая и младшая половины 128-битного произведения, сложенные вместе
+uint64_t MultiplyFold(uint64_t lhs, uint64_t rhs) {
+    const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+// Первые size байт data, size не больше 8
+uint64_t ReadWord(const char* data, size_t size) {
+    uint64_t word = 0;
+    if (size > 0) {
+        std::memcpy(&word, data, size);
+    }
+    return word;
+}
+
+// Строка читается по 16 байт, на каждые 16 байт приходится одно умножение.
+// Названия остановок обычно короче 32 байт, так что выходит одно-два умножения
+uint64_t HashString(std::string_view str, uint64_t seed) {
+    constexpr uint64_t LOW_KEY = 0xa0761d6478bd642fULL;
+    constexpr uint64_t HIGH_KEY = 0xe7037ed1a0b428dbULL;
+
+    const char* data = str.data();
+    size_t size = str.size();
+    uint64_t hash = seed ^ size;
+
+    for (; size > 16; data += 16, size -= 16) {
+        hash = MultiplyFold(ReadWord(data, 8) ^ LOW_KEY, ReadWord(data + 8, 8) ^ hash);
+    }
+
+    const uint64_t low = ReadWord(data, std::min<size_t>(size, 8));
+    const uint64_t high = size > 8 ? ReadWord(data + 8, size - 8) : 0;
+    return MultiplyFold(low ^ LOW_KEY, high ^ hash ^ HIGH_KEY);
+}
+
+// Равномерно отображает 64-битное значение на [0, range) без деления
+size_t Reduce(uint64_t value, size_t range) {
+    return static_cast<size_t>((static_cast<unsigned __int128>(value) * range) >> 64);
+}
+
+size_t Displace(uint64_t hash, uint32_t displacement, size_t size) {
+    return Reduce(Mix(hash + displacement * 0x9e3779b97f4a7c15ULL), size);
+}
+
+/*
+ * Корзина из одного ключа, когда свободны k позиций, находит свою в среднем за n / k попыток.
+ * Предел в MAX_DISPLACEMENT_PER_KEY · n попыток последняя корзина превышает с вероятностью
+ * около e^-8, все вместе — около 0.03%. Тогда построение начинается заново с другим зерном,
+ * а не перебирает смещения дальше: неудачное зерно иначе стоило бы до 2^32 попыток
+ */
+constexpr size_t MAX_DISPLACEMENT_PER_KEY = 8;
+// Для малых наборов предел побольше: корзина из двух ключей при n = 2 подходит лишь в половине попыток
+constexpr size_t MIN_MAX_DISPLACEMENT = 1024;
+constexpr int MAX_SEEDS = 16;
+
+}  // namespace
+
+PerfectHash::PerfectHash(std::span<const std::string_view> keys)
+    : size_(keys.size()) {
+    if (keys.empty()) {
+        return;
+    }
+
+    std::vector<uint64_t> hashes(keys.size());
+    // Построение не удаётся, если у двух ключей совпали все 64 бита хеша или какой-то корзине
+    // не нашлось смещения в пределах max_displacement
+    for (int attempt = 0; attempt < MAX_SEEDS; ++attempt) {
+        seed_ = Mix(attempt + 1);
+        std::transform(keys.begin(), keys.end(), hashes.begin(), [this](std::string_view key) {
+            return HashString(key, seed_);
+        });
+        if (TryBuild(hashes)) {
+            return;
+        }
+    }
+
+    throw std::runtime_error{"Can't build perfect hash"};
+}
+
+uint64_t PerfectHash::Hash(std::string_view key) const {
+    return HashString(key, seed_);
+}
+
+size_t PerfectHash::GetPosition(uint64_t hash) const {
+    if (size_ == 0) {
+        return 0;
+    }
+
+    return Displace(hash, displacements_[Reduce(hash, displacements_.size())], size_);
+}
+
+bool PerfectHash::TryBuild(std::span<const uint64_t> hashes) {
+    const size_t buckets_count = (size_ + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    displacements_.assign(buckets_count, 0);
+
+    // Ключи, сгруппированные по корзинам: корзина b — отрезок [bucket_begin[b], bucket_begin[b + 1])
+    std::vector<uint32_t> bucket_begin(buckets_count + 1, 0);
+    for (uint64_t hash : hashes) {
+        ++bucket_begin[Reduce(hash, buckets_count) + 1];
+    }
+    std::partial_sum(bucket_begin.begin(), bucket_begin.end(), bucket_begin.begin());
+
+    std::vector<uint64_t> bucket_hashes(hashes.size());
+    std::vector<uint32_t> fill(bucket_begin.begin(), bucket_begin.end() - 1);
+    for (uint64_t hash : hashes) {
+        bucket_hashes[fill[Reduce(hash, buckets_count)]++] = hash;
+    }
+
+    // Большие корзины размещаются первыми, пока свободных позиций много
+    std::vector<uint32_t> order(buckets_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&bucket_begin](uint32_t lhs, uint32_t rhs) {
+        return bucket_begin[lhs + 1] - bucket_begin[lhs] > bucket_begin[rhs + 1] - bucket_begin[rhs];
+    });
+
+    const uint32_t max_displacement = static_cast<uint32_t>(
+        std::min<size_t>(std::max(size_ * MAX_DISPLACEMENT_PER_KEY, MIN_MAX_DISPLACEMENT), UINT32_MAX));
+
+    std::vector<bool> taken(size_, false);
+    std::vector<size_t> positions;
+    for (uint32_t bucket : order) {
+        const std::span<const uint64_t> bucket_keys(bucket_hashes.data() + bucket_begin[bucket],
+                                                    bucket_begin[bucket + 1] - bucket_begin[bucket]);
+        if (bucket_keys.empty()) {
+            break;
+        }
+        // Ключи с одинаковым хешем не развести никаким смещением
+        for (size_t i = 0; i < bucket_keys.size(); ++i) {
+            if (std::find(bucket_keys.begin() + i + 1, bucket_keys.end(), bucket_keys[i]) != bucket_keys.end()) {
+                return false;
+            }
+        }
+
+        uint32_t displacement = 0;
+        for (;; ++displacement) {
+            if (displacement == max_displacement) {
+                return false;
+            }
+
+            positions.clear();
+            bool fits = true;
+            for (uint64_t hash : bucket_keys) {
+                const size_t position = Displace(hash, displacement, size_);
+                if (taken[position] || std::find(positions.begin(), positions.end(), position) != positions.end()) {
+                    fits = false;
+                    break;
+                }
+                positions.push_back(position);
+            }
+            if (fits) {
+                break;
+            }
+        }
+
+        displacements_[bucket] = displacement;
+        for (size_t position : positions) {
+            taken[position] = true;
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace transport_catalogue {
+
+/*
+ * Минимальная совершенная хеш-функция для неизменного набора различных строк
+ * (схема «hash and displace», CHD). Ключи хешируются один раз и раскладываются по корзинам
+ * в среднем по BUCKET_SIZE ключей. Для каждой корзины при построении подбирается смещение,
+ * при котором её ключи попадают в свободные позиции 0..n-1. Вычисление — один проход
+ * по строке, чтение смещения корзины и перемешивание
+ */
+class PerfectHash {
+public:
+    PerfectHash() = default;
+
+    // Строки keys должны быть различны
+    explicit PerfectHash(std::span<const std::string_view> keys);
+
+    // Позиция ключа из набора. Для прочих строк — какая-то позиция из 0..n-1,
+    // поэтому найденный по ней ключ нужно сравнить с искомым
+    size_t operator()(std::string_view key) const {
+        return GetPosition(Hash(key));
+    }
+
+    // То же в два шага: младшие биты хеша пригодны как отпечаток ключа,
+    // чтобы отсеять чужую строку без сравнения
+    uint64_t Hash(std::string_view key) const;
+    size_t GetPosition(uint64_t hash) const;
+
+    // Число ключей, 0 — функция не построена
+    size_t Size() const {
+        return size_;
+    }
+
+private:
+    // Чем меньше корзины, тем быстрее для них находятся смещения: при 4 ключах на корзину
+    // построение по миллиону строк втрое дольше, чем при 2, а таблица смещений меньше лишь на 1 байт на ключ
+    static constexpr size_t BUCKET_SIZE = 2;
+
+    bool TryBuild(std::span<const uint64_t> hashes);
+
+    uint64_t seed_ = 0;
+    size_t size_ = 0;
+    std::vector<uint32_t> displacements_;
+};
+
+}
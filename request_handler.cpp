@@ -1,55 +1,205 @@
 #include "request_handler.h"
 #include <algorithm>
+#include <exception>
 
 namespace transport_catalogue {
 
-RequestHandler::RequestHandler(TransportCatalogue &db, const MapRenderer &renderer)
-    : db_(db), renderer_(renderer)
+RequestHandler::RequestHandler(VersionedCatalogue &db, const MapRenderer &renderer)
+    : db_(db), snapshot_(db.GetSnapshot()), renderer_(renderer)
 {}
 
+namespace {
+
+// Некольцевой маршрут проходится до конечной и обратно, остановки обратного пути дописываются в конец
+void ExpandStops(std::vector<std::string_view>& stops) {
+    if (stops.empty()) {
+        return;
+    }
+
+    stops.reserve(stops.size() * 2 - 1);
+    for (size_t i = stops.size() - 1; i > 0; --i) {
+        stops.push_back(stops[i - 1]);
+    }
+}
+
+}  // namespace
+
 void RequestHandler::AddBus(std::string_view title, const std::vector<std::string_view> &stops, bool is_roundtrip) {
     if(!is_roundtrip) {
         std::vector<std::string_view> expanded_stops(stops);
+        ExpandStops(expanded_stops);
+
+        db_.Update([&](TransportCatalogue& catalogue) {
+            catalogue.AddBus(title, expanded_stops, is_roundtrip);
+        });
+        return;
+    }
+
+    db_.Update([&](TransportCatalogue& catalogue) {
+        catalogue.AddBus(title, stops, is_roundtrip);
+    });
+}
 
-        for (auto stop_it = stops.rbegin() + 1; stop_it != stops.rend(); ++stop_it) {
-            expanded_stops.push_back(*stop_it);
+void RequestHandler::AddBulk(TransportCatalogue::BulkData data) {
+    for (TransportCatalogue::BusData& bus : data.buses) {
+        if (!bus.is_roundtrip) {
+            ExpandStops(bus.stops);
         }
+    }
 
-        db_.AddBus(title, expanded_stops, is_roundtrip);
+    db_.Update([&](TransportCatalogue& catalogue) {
+        catalogue.AddBulk(data);
+        if (freeze_names_) {
+            catalogue.Freeze();
+        }
+    });
+}
+
+void RequestHandler::BeginBatch() {
+    VersionedCatalogue::Snapshot snapshot = db_.GetSnapshot();
+    if (snapshot.version == snapshot_.version) {
         return;
     }
 
-    db_.AddBus(title, stops, is_roundtrip);
+    // Граф построен по прежней версии
+    snapshot_ = std::move(snapshot);
+    router_.reset();
+    route_workspace_.reset();
+}
+
+const TransportCatalogue& RequestHandler::GetCatalogue() const {
+    return *snapshot_;
 }
 
 std::string RequestHandler::RenderMap() const {
+    const TransportCatalogue& db = GetCatalogue();
 
-    const std::deque<Bus>& buses = db_.GetBuses();
-    std::vector<const Bus*> sorted_buses;
-    sorted_buses.reserve(buses.size());
-    for (const Bus& bus : buses) {
-        sorted_buses.push_back(&bus);
+    std::vector<Bus> sorted_buses;
+    sorted_buses.reserve(db.GetBusesCount());
+    for (BusId id = 0; id < db.GetBusesCount(); ++id) {
+        sorted_buses.push_back(db.GetBus(id));
     }
 
-    std::sort(sorted_buses.begin(), sorted_buses.end(), [](const Bus* lhs, const Bus* rhs){
-        return lhs->title < rhs->title;
+    std::sort(sorted_buses.begin(), sorted_buses.end(), [](const Bus& lhs, const Bus& rhs){
+        return lhs.title < rhs.title;
     });
 
 
-    const std::deque<Stop>& stops = db_.GetStops();
-    std::vector<const Stop*> sorted_stops_with_buses;
-    for (const Stop& stop : stops) {
-        if(!db_.GetBusesOfStop(stop.title).empty()) {
-            sorted_stops_with_buses.push_back(&stop);
+    std::vector<Stop> sorted_stops_with_buses;
+    for (StopId id = 0; id < db.GetStopsCount(); ++id) {
+        if(!db.GetBusesOfStop(id).empty()) {
+            sorted_stops_with_buses.push_back(db.GetStop(id));
         }
     }
 
-    std::sort(sorted_stops_with_buses.begin(), sorted_stops_with_buses.end(), [](const Stop* lhs, const Stop* rhs) {
-        return lhs->title < rhs->title;
+    std::sort(sorted_stops_with_buses.begin(), sorted_stops_with_buses.end(), [](const Stop& lhs, const Stop& rhs) {
+        return lhs.title < rhs.title;
     });
 
-    return renderer_.Render(sorted_buses, sorted_stops_with_buses);
+    return renderer_.Render(sorted_buses, sorted_stops_with_buses, db.GetStopsCoordinates());
+}
+
+void RequestHandler::SetRoutingSettings(RoutingSettings settings) {
+    routing_settings_ = settings;
+    router_.reset();
+    route_workspace_.reset();
+}
+
+const RoutingSettings& RequestHandler::GetRoutingSettings() const {
+    return routing_settings_;
+}
+
+void RequestHandler::UseContractionHierarchy(bool use) {
+    use_contraction_hierarchy_ = use;
+    router_.reset();
+    route_workspace_.reset();
+}
+
+void RequestHandler::FreezeNamesAfterLoad(bool freeze) {
+    freeze_names_ = freeze;
+}
+
+void RequestHandler::SetRouterCache(std::string path) {
+    router_cache_path_ = std::move(path);
+    router_.reset();
+    route_workspace_.reset();
+}
+
+std::optional<TransportRouter::Route> RequestHandler::FindRoute(std::string_view from, std::string_view to) {
+    const std::optional<StopId> from_id = GetCatalogue().FindStop(from);
+    const std::optional<StopId> to_id = GetCatalogue().FindStop(to);
+    if (!from_id || !to_id) {
+        return std::nullopt;
+    }
+
+    const TransportRouter& router = GetRouter();
+    return router.FindRoute(*from_id, *to_id, *route_workspace_);
+}
+
+std::optional<std::vector<double>> RequestHandler::ComputeMatrix(const std::vector<std::string_view>& from,
+                                                                 const std::vector<std::string_view>& to) {
+    const std::optional<std::vector<StopId>> from_ids = FindStops(from);
+    const std::optional<std::vector<StopId>> to_ids = FindStops(to);
+    if (!from_ids || !to_ids) {
+        return std::nullopt;
+    }
+
+    return GetRouter().ComputeMatrix(*from_ids, *to_ids);
+}
+
+std::optional<std::span<const TransportRouter::ReachableStop>> RequestHandler::FindReachable(
+        std::string_view from, TransportRouter::CostType cost_type, double max_cost) {
+    const std::optional<StopId> from_id = GetCatalogue().FindStop(from);
+    if (!from_id) {
+        return std::nullopt;
+    }
+
+    const TransportRouter& router = GetRouter();
+    return router.FindReachable(*from_id, cost_type, max_cost, *route_workspace_);
+}
+
+const TransportRouter& RequestHandler::GetRouter() {
+    if (!router_) {
+        std::optional<TransportRouter> cached;
+        if (!router_cache_path_.empty()) {
+            cached = TransportRouter::Load(router_cache_path_, GetCatalogue(), routing_settings_);
+        }
+
+        const bool is_cache_valid = cached && cached->IsContracted() == use_contraction_hierarchy_;
+        if (is_cache_valid) {
+            router_ = std::make_unique<TransportRouter>(std::move(*cached));
+        } else {
+            router_ = std::make_unique<TransportRouter>(GetCatalogue(), routing_settings_);
+            if (use_contraction_hierarchy_) {
+                router_->Contract();
+            }
+        }
+        route_workspace_ = std::make_unique<TransportRouter::Workspace>(*router_);
+
+        // Кэш только ускоряет следующий запуск: если файл не записать, запросы всё равно обслуживаются
+        if (!is_cache_valid && !router_cache_path_.empty()) {
+            try {
+                router_->Save(router_cache_path_);
+            } catch (const std::exception&) {
+            }
+        }
+    }
+
+    return *router_;
 }
 
+std::optional<std::vector<StopId>> RequestHandler::FindStops(const std::vector<std::string_view>& titles) const {
+    std::vector<StopId> ids;
+    ids.reserve(titles.size());
+    for (std::string_view title : titles) {
+        const std::optional<StopId> id = GetCatalogue().FindStop(title);
+        if (!id) {
+            return std::nullopt;
+        }
+        ids.push_back(*id);
+    }
+
+    return ids;
 }
 
+}
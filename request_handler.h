@@ -1,19 +1,76 @@
 #pragma once
 
-#include "transport_catalogue.h"
+#include "versioned_catalogue.h"
 #include "map_renderer.h"
+#include "transport_router.h"
+
+#include <memory>
+#include <optional>
+#include <string>
 
 namespace transport_catalogue {
 
+/*
+ * Изменения публикуются новыми версиями справочника, а запросы читают снимок, взятый
+ * в начале пачки. Пока пачка обслуживается, справочник могут обновлять другие потоки:
+ * ответы одной пачки согласованы между собой, а граф маршрутов строится заново,
+ * только когда новая пачка видит новую версию
+ */
 class RequestHandler {
 public:
-    RequestHandler(TransportCatalogue& db, const MapRenderer& renderer);
+    RequestHandler(VersionedCatalogue& db, const MapRenderer& renderer);
 
+    // Изменения видны в GetCatalogue и запросах после следующего BeginBatch
     void AddBus(std::string_view title, const std::vector<std::string_view> &stops, bool is_roundtrip);
+    // Как AddBus для каждого маршрута, но всё добавляется одной версией через AddBulk.
+    // С FreezeNamesAfterLoad справочник после этого замораживается
+    void AddBulk(TransportCatalogue::BulkData data);
+
+    // Берёт снимок последней версии справочника для следующей пачки запросов
+    void BeginBatch();
+    // Снимок, из которого отвечает текущая пачка запросов
+    const TransportCatalogue& GetCatalogue() const;
+
     std::string RenderMap() const;
+
+    void SetRoutingSettings(RoutingSettings settings);
+    const RoutingSettings& GetRoutingSettings() const;
+    // С включённой иерархией сжатия граф дольше строится, зато поиски намного быстрее.
+    // Имеет смысл при большом числе запросов Route
+    void UseContractionHierarchy(bool use);
+    // Замораживать ли справочник после AddBulk, см. TransportCatalogue::Freeze. Поиск по названиям
+    // становится быстрее на справочниках до сотни тысяч названий, но на миллионе он медленнее,
+    // а заморозка занимает сотни миллисекунд. Поэтому по умолчанию выключено
+    void FreezeNamesAfterLoad(bool freeze);
+    // Граф загружается из файла path, если он построен по тому же справочнику и настройкам,
+    // иначе строится и сохраняется туда. Пустой путь отключает кэш
+    void SetRouterCache(std::string path);
+    // Самый быстрый путь между остановками или nullopt, если какой-то из них нет или между
+    // ними не проехать. Граф строится при первом поиске, route.rides действителен до следующего
+    std::optional<TransportRouter::Route> FindRoute(std::string_view from, std::string_view to);
+    // Время между остановками from и to, как в TransportRouter::ComputeMatrix,
+    // или nullopt, если какой-то из остановок нет
+    std::optional<std::vector<double>> ComputeMatrix(const std::vector<std::string_view>& from,
+                                                     const std::vector<std::string_view>& to);
+    // Остановки, до которых из from можно добраться с ценой не больше max_cost,
+    // как в TransportRouter::FindReachable, или nullopt, если остановки from нет
+    std::optional<std::span<const TransportRouter::ReachableStop>> FindReachable(
+            std::string_view from, TransportRouter::CostType cost_type, double max_cost);
 private:
-    TransportCatalogue& db_;
+    // Граф строится по снимку при первом обращении
+    const TransportRouter& GetRouter();
+    std::optional<std::vector<StopId>> FindStops(const std::vector<std::string_view>& titles) const;
+
+    VersionedCatalogue& db_;
+    VersionedCatalogue::Snapshot snapshot_;
     const MapRenderer& renderer_;
+
+    RoutingSettings routing_settings_;
+    bool use_contraction_hierarchy_ = false;
+    bool freeze_names_ = false;
+    std::string router_cache_path_;
+    std::unique_ptr<TransportRouter> router_;
+    std::unique_ptr<TransportRouter::Workspace> route_workspace_;
 };
 
 }
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace transport_catalogue {
+
+/*
+ * Массивы, копия которых делит память с оригиналом. Копирование стоит порядка числа
+ * блоков, а не элементов, а изменения копии не видны в оригинале и наоборот.
+ * На них держатся версии справочника в VersionedCatalogue: новая версия — копия текущей,
+ * в которой изменены немногие элементы, а остальное общее с прежними версиями
+ */
+
+/*
+ * Массив, в который только дописывают в конец. Элементы лежат подряд в общем буфере,
+ * копия видит в нём первые size() элементов. Дописывать на место в свободный хвост буфера
+ * может только один из массивов, которые его делят: право на хвост переходит к копии.
+ * Остальные при дописывании переезжают в новый буфер. Записанные элементы не меняются,
+ * поэтому копию можно читать из других потоков, пока в оригинал дописывают, и наоборот
+ */
+template <typename T>
+class AppendArray {
+public:
+    AppendArray() = default;
+
+    AppendArray(const AppendArray& other)
+        : buffer_(other.buffer_)
+        , size_(other.size_)
+        , owns_tail_(other.owns_tail_.exchange(false, std::memory_order_relaxed)) {
+    }
+
+    AppendArray(AppendArray&& other) noexcept
+        : buffer_(std::move(other.buffer_))
+        , size_(std::exchange(other.size_, 0))
+        , owns_tail_(other.owns_tail_.exchange(false, std::memory_order_relaxed)) {
+    }
+
+    AppendArray& operator=(const AppendArray&) = delete;
+
+    AppendArray& operator=(AppendArray&& other) noexcept {
+        buffer_ = std::move(other.buffer_);
+        size_ = std::exchange(other.size_, 0);
+        owns_tail_.store(other.owns_tail_.exchange(false, std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    const T* data() const {
+        return buffer_ ? buffer_->data.get() : nullptr;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    const T& operator[](size_t index) const {
+        return buffer_->data[index];
+    }
+
+    const T& back() const {
+        return buffer_->data[size_ - 1];
+    }
+
+    const T* begin() const {
+        return data();
+    }
+
+    const T* end() const {
+        return data() + size_;
+    }
+
+    operator std::span<const T>() const {
+        return {data(), size_};
+    }
+
+    void PushBack(const T& value) {
+        if (!HasRoomFor(1)) {
+            Grow(size_ + 1);
+        }
+        buffer_->data[size_++] = value;
+    }
+
+    void Append(std::span<const T> values) {
+        if (values.empty()) {
+            return;
+        }
+        if (!HasRoomFor(values.size())) {
+            Grow(size_ + values.size());
+        }
+        std::copy(values.begin(), values.end(), buffer_->data.get() + size_);
+        size_ += values.size();
+    }
+
+    // Готовит массив к дописыванию до capacity элементов без переездов
+    void Reserve(size_t capacity) {
+        if (capacity > size_ && !HasRoomFor(capacity - size_)) {
+            Grow(capacity);
+        }
+    }
+
+private:
+    struct Buffer {
+        std::unique_ptr<T[]> data;
+        size_t capacity = 0;
+    };
+
+    bool HasRoomFor(size_t count) const {
+        return owns_tail_.load(std::memory_order_relaxed) && buffer_->capacity - size_ >= count;
+    }
+
+    // Переезд в новый буфер не меньше чем на capacity элементов, с запасом на удвоение
+    void Grow(size_t capacity) {
+        capacity = std::max({capacity, size_ * 2, size_t{16}});
+        auto buffer = std::make_shared<Buffer>(Buffer{std::make_unique_for_overwrite<T[]>(capacity), capacity});
+        std::copy(begin(), end(), buffer->data.get());
+        buffer_ = std::move(buffer);
+        owns_tail_.store(true, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<Buffer> buffer_;
+    size_t size_ = 0;
+    // Можно ли писать в buffer_ после size_. Меняется и при копировании, поэтому атомарный
+    mutable std::atomic<bool> owns_tail_ = false;
+};
+
+/*
+ * Массив из блоков по CHUNK_SIZE элементов. Копия делит блоки с оригиналом и помечает
+ * их общими, а общий блок перед изменением копируется. Изменение элемента стоит копии
+ * одного блока, а не всего массива. Элементы можно менять, пока другие потоки читают
+ * копию массива, но не сам массив
+ */
+template <typename T, size_t CHUNK_SIZE = 1024>
+class ChunkedArray {
+public:
+    ChunkedArray() = default;
+
+    explicit ChunkedArray(size_t size, const T& value = T{}) {
+        Resize(size, value);
+    }
+
+    ChunkedArray(const ChunkedArray& other)
+        : chunks_(other.chunks_)
+        , size_(other.size_) {
+        for (const std::shared_ptr<Chunk>& chunk : chunks_) {
+            chunk->shared.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    ChunkedArray(ChunkedArray&& other) noexcept
+        : chunks_(std::move(other.chunks_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    ChunkedArray& operator=(const ChunkedArray&) = delete;
+
+    ChunkedArray& operator=(ChunkedArray&& other) noexcept {
+        chunks_ = std::move(other.chunks_);
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    const T& operator[](size_t index) const {
+        return chunks_[index / CHUNK_SIZE]->items[index % CHUNK_SIZE];
+    }
+
+    // Элемент для изменения. Если его блок общий с копией, блок сначала копируется
+    T& Mutable(size_t index) {
+        std::shared_ptr<Chunk>& chunk = chunks_[index / CHUNK_SIZE];
+        if (chunk->shared.load(std::memory_order_relaxed)) {
+            chunk = std::make_shared<Chunk>(*chunk);
+        }
+        return chunk->items[index % CHUNK_SIZE];
+    }
+
+    // Дописывает элемент, созданный конструктором по умолчанию, и возвращает его
+    T& EmplaceBack() {
+        if (size_ % CHUNK_SIZE == 0) {
+            chunks_.push_back(std::make_shared<Chunk>());
+        }
+        return Mutable(size_++);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack() = value;
+    }
+
+    // Увеличивает массив до size элементов, равных value
+    void Resize(size_t size, const T& value = T{}) {
+        while (size_ < size && size_ % CHUNK_SIZE != 0) {
+            PushBack(value);
+        }
+        for (; size_ < size; size_ = std::min(size, size_ + CHUNK_SIZE)) {
+            auto chunk = std::make_shared<Chunk>();
+            chunk->items.fill(value);
+            chunks_.push_back(std::move(chunk));
+        }
+    }
+
+    void Reserve(size_t capacity) {
+        chunks_.reserve((capacity + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    }
+
+private:
+    struct Chunk {
+        Chunk() = default;
+
+        Chunk(const Chunk& other)
+            : items(other.items) {
+        }
+
+        std::array<T, CHUNK_SIZE> items{};
+        // Блок достался копии массива. Сбрасывается только копированием блока
+        std::atomic<bool> shared = false;
+    };
+
+    std::vector<std::shared_ptr<Chunk>> chunks_;
+    size_t size_ = 0;
+};
+
+}
@@ -0,0 +1,262 @@
+#define _USE_MATH_DEFINES
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace geo {
+
+namespace {
+
+// Листья дерева содержат не больше стольких точек
+constexpr uint32_t LEAF_SIZE = 8;
+
+// Квадрат длины хорды единичной сферы, стягивающей дугу длиной distance метров
+double ChordSquared(double distance) {
+    const double angle = std::min(distance / EARTH_RADIUS, M_PI);
+    const double chord = 2 * std::sin(angle / 2);
+    return chord * chord;
+}
+
+bool LngInRange(double lng, double west, double east) {
+    return west <= east ? west <= lng && lng <= east : lng >= west || lng <= east;
+}
+
+}  // namespace
+
+SpatialIndex::SpatialIndex(std::span<const Coordinates> points) {
+    if (points.empty()) {
+        return;
+    }
+
+    ids_.resize(points.size());
+    std::iota(ids_.begin(), ids_.end(), 0);
+    coords_.assign(points.begin(), points.end());
+    points_.reserve(points.size());
+    for (Coordinates coords : points) {
+        points_.push_back(ToSpherePoint(coords));
+    }
+
+    nodes_.reserve(2 * points.size() / LEAF_SIZE + 1);
+    Build(0, static_cast<uint32_t>(points.size()));
+
+    // Build переставлял только номера — раскладываем точки в порядке дерева
+    std::vector<SpherePoint> ordered_points(points_.size());
+    std::vector<Coordinates> ordered_coords(coords_.size());
+    for (size_t i = 0; i < ids_.size(); ++i) {
+        ordered_points[i] = points_[ids_[i]];
+        ordered_coords[i] = coords_[ids_[i]];
+    }
+    points_ = std::move(ordered_points);
+    coords_ = std::move(ordered_coords);
+}
+
+std::vector<uint32_t> SpatialIndex::FindNearest(Coordinates center, size_t count) const {
+    std::vector<uint32_t> result;
+    if (nodes_.empty() || count == 0) {
+        return result;
+    }
+
+    const SpherePoint target = ToSpherePoint(center);
+
+    // Лучшие найденные точки: на вершине кучи — самая дальняя из них
+    std::vector<std::pair<double, uint32_t>> best;
+    best.reserve(count + 1);
+
+    // Узлы обходятся по возрастанию расстояния до них
+    using QueueItem = std::pair<double, uint32_t>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> queue;
+    queue.emplace(SquaredDistance(target, nodes_[0]), 0);
+
+    while (!queue.empty()) {
+        const auto [node_distance, node_index] = queue.top();
+        queue.pop();
+
+        if (best.size() == count && node_distance > best.front().first) {
+            break;
+        }
+
+        const Node& node = nodes_[node_index];
+        if (node.left) {
+            queue.emplace(SquaredDistance(target, nodes_[node.left]), node.left);
+            queue.emplace(SquaredDistance(target, nodes_[node.right]), node.right);
+            continue;
+        }
+
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            const std::pair<double, uint32_t> candidate{SquaredDistance(target, points_[i]), ids_[i]};
+            if (best.size() < count) {
+                best.push_back(candidate);
+                std::push_heap(best.begin(), best.end());
+            } else if (candidate < best.front()) {
+                std::pop_heap(best.begin(), best.end());
+                best.back() = candidate;
+                std::push_heap(best.begin(), best.end());
+            }
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    result.reserve(best.size());
+    for (const auto& [distance, id] : best) {
+        result.push_back(id);
+    }
+
+    return result;
+}
+
+std::vector<uint32_t> SpatialIndex::FindWithinRadius(Coordinates center, double radius) const {
+    std::vector<uint32_t> result;
+    if (nodes_.empty() || radius < 0) {
+        return result;
+    }
+
+    const SpherePoint target = ToSpherePoint(center);
+    const double max_distance = ChordSquared(radius);
+
+    std::vector<std::pair<double, uint32_t>> found;
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+
+        if (SquaredDistance(target, node) > max_distance) {
+            continue;
+        }
+        if (node.left) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            const double distance = SquaredDistance(target, points_[i]);
+            if (distance <= max_distance) {
+                found.emplace_back(distance, ids_[i]);
+            }
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    result.reserve(found.size());
+    for (const auto& [distance, id] : found) {
+        result.push_back(id);
+    }
+
+    return result;
+}
+
+std::vector<uint32_t> SpatialIndex::FindInBox(Coordinates south_west, Coordinates north_east) const {
+    std::vector<uint32_t> result;
+    if (nodes_.empty() || south_west.lat > north_east.lat) {
+        return result;
+    }
+
+    const double west = south_west.lng;
+    const double east = north_east.lng;
+
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+
+        if (node.max_lat < south_west.lat || node.min_lat > north_east.lat) {
+            continue;
+        }
+        const bool lng_overlaps = west <= east
+            ? node.max_lng >= west && node.min_lng <= east
+            : node.max_lng >= west || node.min_lng <= east;
+        if (!lng_overlaps) {
+            continue;
+        }
+
+        const bool lng_inside = west <= east
+            ? node.min_lng >= west && node.max_lng <= east
+            : node.min_lng >= west || node.max_lng <= east;
+        if (lng_inside && node.min_lat >= south_west.lat && node.max_lat <= north_east.lat) {
+            result.insert(result.end(), ids_.begin() + node.begin, ids_.begin() + node.end);
+            continue;
+        }
+        if (node.left) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            const Coordinates coords = coords_[i];
+            if (coords.lat >= south_west.lat && coords.lat <= north_east.lat && LngInRange(coords.lng, west, east)) {
+                result.push_back(ids_[i]);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+double SpatialIndex::SquaredDistance(SpherePoint lhs, SpherePoint rhs) {
+    const double dx = lhs.x - rhs.x;
+    const double dy = lhs.y - rhs.y;
+    const double dz = lhs.z - rhs.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+double SpatialIndex::SquaredDistance(SpherePoint point, const Node& node) {
+    const double dx = std::max({node.min.x - point.x, 0.0, point.x - node.max.x});
+    const double dy = std::max({node.min.y - point.y, 0.0, point.y - node.max.y});
+    const double dz = std::max({node.min.z - point.z, 0.0, point.z - node.max.z});
+    return dx * dx + dy * dy + dz * dz;
+}
+
+uint32_t SpatialIndex::Build(uint32_t begin, uint32_t end) {
+    const uint32_t index = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+
+    Node node;
+    node.begin = begin;
+    node.end = end;
+    node.min = node.max = points_[ids_[begin]];
+    node.min_lat = node.max_lat = coords_[ids_[begin]].lat;
+    node.min_lng = node.max_lng = coords_[ids_[begin]].lng;
+    for (uint32_t i = begin + 1; i < end; ++i) {
+        const SpherePoint point = points_[ids_[i]];
+        node.min = {std::min(node.min.x, point.x), std::min(node.min.y, point.y), std::min(node.min.z, point.z)};
+        node.max = {std::max(node.max.x, point.x), std::max(node.max.y, point.y), std::max(node.max.z, point.z)};
+        const Coordinates coords = coords_[ids_[i]];
+        node.min_lat = std::min(node.min_lat, coords.lat);
+        node.max_lat = std::max(node.max_lat, coords.lat);
+        node.min_lng = std::min(node.min_lng, coords.lng);
+        node.max_lng = std::max(node.max_lng, coords.lng);
+    }
+
+    if (end - begin > LEAF_SIZE) {
+        // Делим по оси, вдоль которой точки узла разбросаны сильнее всего
+        const double extent_x = node.max.x - node.min.x;
+        const double extent_y = node.max.y - node.min.y;
+        const double extent_z = node.max.z - node.min.z;
+        double SpherePoint::* axis = &SpherePoint::z;
+        if (extent_x >= extent_y && extent_x >= extent_z) {
+            axis = &SpherePoint::x;
+        } else if (extent_y >= extent_z) {
+            axis = &SpherePoint::y;
+        }
+
+        const uint32_t middle = begin + (end - begin) / 2;
+        std::nth_element(ids_.begin() + begin, ids_.begin() + middle, ids_.begin() + end,
+                         [this, axis](uint32_t lhs, uint32_t rhs) {
+                             return points_[lhs].*axis < points_[rhs].*axis;
+                         });
+
+        node.left = Build(begin, middle);
+        node.right = Build(middle, end);
+    }
+
+    nodes_[index] = node;
+    return index;
+}
+
+}  // namespace geo
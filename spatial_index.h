@@ -0,0 +1,64 @@
+#pragma once
+
+#include "geo.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace geo {
+
+/*
+ * Пространственный индекс точек земной поверхности — k-d дерево.
+ * Точки переводятся в трёхмерные координаты на единичной сфере: длина хорды между
+ * ними монотонно зависит от расстояния по дуге, поэтому поиск ближайших точек
+ * и точек в круге точный и не ломается у полюсов и на 180-м меридиане.
+ * Каждый узел помнит ещё и границы своих точек по широте и долготе для запросов
+ * по прямоугольнику. Запросы возвращают номера точек в исходном массиве
+ */
+class SpatialIndex {
+public:
+    SpatialIndex() = default;
+    explicit SpatialIndex(std::span<const Coordinates> points);
+
+    // Не больше count ближайших к center точек по возрастанию расстояния
+    std::vector<uint32_t> FindNearest(Coordinates center, size_t count) const;
+
+    // Точки не дальше radius метров от center по возрастанию расстояния
+    std::vector<uint32_t> FindWithinRadius(Coordinates center, double radius) const;
+
+    // Точки, у которых широта и долгота лежат между границами south_west и north_east
+    // включительно, по возрастанию номера. Если south_west.lng > north_east.lng,
+    // прямоугольник пересекает 180-й меридиан
+    std::vector<uint32_t> FindInBox(Coordinates south_west, Coordinates north_east) const;
+
+private:
+    struct Node {
+        // Точки узла занимают отрезок [begin, end) в points_
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        // Дочерние узлы. У листа их нет, корень ничьим ребёнком не бывает
+        uint32_t left = 0;
+        uint32_t right = 0;
+        SpherePoint min;
+        SpherePoint max;
+        double min_lat = 0;
+        double max_lat = 0;
+        double min_lng = 0;
+        double max_lng = 0;
+    };
+
+    static double SquaredDistance(SpherePoint lhs, SpherePoint rhs);
+    // Квадрат расстояния от точки до параллелепипеда узла, 0 — если точка внутри
+    static double SquaredDistance(SpherePoint point, const Node& node);
+
+    uint32_t Build(uint32_t begin, uint32_t end);
+
+    std::vector<Node> nodes_;
+    // Точки в порядке обхода дерева и их номера в исходном массиве
+    std::vector<SpherePoint> points_;
+    std::vector<Coordinates> coords_;
+    std::vector<uint32_t> ids_;
+};
+
+}  // namespace geo
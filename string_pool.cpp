@@ -0,0 +1,185 @@
+#include "string_pool.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+namespace transport_catalogue {
+
+StringPool::StringPool(size_t chunk_size)
+    : chunk_size_(chunk_size) {}
+
+// Копия не дописывает в блок оригинала: её строки начинаются с нового блока
+StringPool::StringPool(const StringPool& other)
+    : chunk_size_(other.chunk_size_)
+    , chunks_(other.chunks_)
+    , chunk_sizes_(other.chunk_sizes_)
+    , strings_(other.strings_)
+    , index_(other.index_)
+    , frozen_(other.frozen_) {
+}
+
+StringPool::Handle StringPool::Intern(std::string_view str) {
+    if (IsFrozen()) {
+        if (std::optional<Handle> handle = Find(str)) {
+            return *handle;
+        }
+        Unfreeze();
+    }
+
+    if ((strings_.size() + 1) * 2 > index_.size()) {
+        RebuildIndex(std::max<size_t>(index_.size() * 2, 16));
+    }
+
+    const uint64_t hash = HashString(str);
+    const size_t slot = FindIndexSlot(str, hash);
+    if (index_[slot].handle != NO_HANDLE) {
+        return index_[slot].handle;
+    }
+
+    const Handle handle = static_cast<Handle>(strings_.size());
+    strings_.PushBack(Store(str));
+    index_.Mutable(slot) = {handle, static_cast<uint32_t>(hash >> 32)};
+
+    return handle;
+}
+
+std::optional<StringPool::Handle> StringPool::Find(std::string_view str) const {
+    if (IsFrozen()) {
+        const uint64_t hash = frozen_->hash.Hash(str);
+        const FrozenSlot& slot = frozen_->slots[frozen_->hash.GetPosition(hash)];
+        if (slot.fingerprint != static_cast<uint32_t>(hash)) {
+            return std::nullopt;
+        }
+
+        const char* record = frozen_->records.data() + slot.offset;
+        Handle handle;
+        uint32_t size;
+        std::memcpy(&handle, record, sizeof(handle));
+        std::memcpy(&size, record + sizeof(handle), sizeof(size));
+
+        if (std::string_view(record + FROZEN_RECORD_HEADER, size) == str) {
+            return handle;
+        }
+        return std::nullopt;
+    }
+
+    if (index_.empty()) {
+        return std::nullopt;
+    }
+
+    const Handle handle = index_[FindIndexSlot(str, HashString(str))].handle;
+    if (handle == NO_HANDLE) {
+        return std::nullopt;
+    }
+
+    return handle;
+}
+
+void StringPool::Freeze() {
+    if (IsFrozen() || strings_.empty()) {
+        return;
+    }
+
+    const size_t records_size = std::accumulate(strings_.begin(), strings_.end(), size_t{0},
+                                                [](size_t sum, std::string_view str) {
+                                                    return sum + FROZEN_RECORD_HEADER + str.size();
+                                                });
+    // Смещения 32-битные. Строк на 4 ГиБ в справочнике не бывает, но тогда пул просто не замораживается
+    if (records_size > UINT32_MAX) {
+        return;
+    }
+
+    auto frozen = std::make_shared<FrozenIndex>();
+    frozen->hash = PerfectHash(strings_);
+
+    // Пока записи не разложены, в offset ячейки временно лежит дескриптор её строки
+    frozen->slots.resize(strings_.size());
+    for (Handle handle = 0; handle < strings_.size(); ++handle) {
+        const uint64_t hash = frozen->hash.Hash(strings_[handle]);
+        frozen->slots[frozen->hash.GetPosition(hash)] = {handle, static_cast<uint32_t>(hash)};
+    }
+
+    frozen->records.resize(records_size);
+    char* record = frozen->records.data();
+    for (FrozenSlot& slot : frozen->slots) {
+        const Handle handle = slot.offset;
+        const std::string_view str = strings_[handle];
+        const uint32_t size = static_cast<uint32_t>(str.size());
+
+        slot.offset = static_cast<uint32_t>(record - frozen->records.data());
+        std::memcpy(record, &handle, sizeof(handle));
+        std::memcpy(record + sizeof(handle), &size, sizeof(size));
+        std::copy(str.begin(), str.end(), record + FROZEN_RECORD_HEADER);
+        record += FROZEN_RECORD_HEADER + size;
+    }
+
+    frozen_ = std::move(frozen);
+    index_ = {};
+}
+
+void StringPool::Unfreeze() {
+    frozen_.reset();
+    RebuildIndex(std::bit_ceil(std::max<size_t>((strings_.size() + 1) * 2, 16)));
+}
+
+void StringPool::Reserve(size_t count) {
+    strings_.Reserve(count);
+    const size_t capacity = std::bit_ceil(count * 2);
+    if (!IsFrozen() && capacity > index_.size()) {
+        RebuildIndex(capacity);
+    }
+}
+
+size_t StringPool::GetStorageBytes() const {
+    return std::accumulate(chunk_sizes_.begin(), chunk_sizes_.end(), size_t{0});
+}
+
+uint64_t StringPool::HashString(std::string_view str) {
+    return std::hash<std::string_view>{}(str);
+}
+
+size_t StringPool::FindIndexSlot(std::string_view str, uint64_t hash) const {
+    const size_t mask = index_.size() - 1;
+    const uint32_t fingerprint = static_cast<uint32_t>(hash >> 32);
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const IndexSlot& entry = index_[slot];
+        if (entry.handle == NO_HANDLE || (entry.fingerprint == fingerprint && strings_[entry.handle] == str)) {
+            return slot;
+        }
+    }
+}
+
+void StringPool::RebuildIndex(size_t capacity) {
+    index_ = ChunkedArray<IndexSlot>(capacity);
+    for (Handle handle = 0; handle < strings_.size(); ++handle) {
+        const uint64_t hash = HashString(strings_[handle]);
+        index_.Mutable(FindIndexSlot(strings_[handle], hash)) = {handle, static_cast<uint32_t>(hash >> 32)};
+    }
+}
+
+std::string_view StringPool::Store(std::string_view str) {
+    if (str.empty()) {
+        return {};
+    }
+
+    if (str.size() > chunk_free_) {
+        // Строка длиннее блока получает отдельный блок своего размера
+        const size_t size = std::max(chunk_size_, str.size());
+        chunks_.emplace_back(new char[size]);
+        chunk_sizes_.push_back(size);
+        chunk_pos_ = chunks_.back().get();
+        chunk_free_ = size;
+    }
+
+    char* data = chunk_pos_;
+    std::memcpy(data, str.data(), str.size());
+    chunk_pos_ += str.size();
+    chunk_free_ -= str.size();
+
+    return {data, str.size()};
+}
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "perfect_hash.h"
+#include "shared_arrays.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace transport_catalogue {
+
+/*
+ * Пул строк: каждая строка хранится ровно один раз в больших непрерывных блоках.
+ * Строке выдаётся дескриптор — номер в порядке добавления. Блоки не перемещаются,
+ * поэтому string_view, полученные из пула, действительны всё время его жизни
+ */
+class StringPool {
+public:
+    using Handle = uint32_t;
+
+    explicit StringPool(size_t chunk_size = 64 * 1024);
+
+    // Копия делит с оригиналом блоки строк и не изменённые части индекса, поэтому
+    // стоит порядка числа строк, делённого на тысячу. Дескрипторы в ней те же
+    StringPool(const StringPool& other);
+    StringPool& operator=(const StringPool&) = delete;
+    StringPool(StringPool&&) = default;
+    StringPool& operator=(StringPool&&) = default;
+
+    // Возвращает дескриптор строки, добавляя её в пул, если её там ещё нет
+    Handle Intern(std::string_view str);
+
+    std::optional<Handle> Find(std::string_view str) const;
+
+    /*
+     * Строит минимальную совершенную хеш-функцию по всем строкам пула. Пока пул заморожен,
+     * Find обходится одним хешированием и одним сравнением строк, а общий индекс не хранится.
+     * Добавление новой строки размораживает пул, Find снова работает через общий индекс
+     */
+    void Freeze();
+
+    bool IsFrozen() const {
+        return frozen_ != nullptr;
+    }
+
+    // Готовит пул к добавлению count строк
+    void Reserve(size_t count);
+
+    std::string_view Get(Handle handle) const {
+        return strings_[handle];
+    }
+
+    size_t Size() const {
+        return strings_.size();
+    }
+
+    // Память под содержимое строк, без учёта индекса
+    size_t GetStorageBytes() const;
+
+private:
+    std::string_view Store(std::string_view str);
+
+    size_t chunk_size_;
+    // Блоки общие с копиями. Пул дописывает строки только в блок, который завёл сам
+    std::vector<std::shared_ptr<char[]>> chunks_;
+    std::vector<size_t> chunk_sizes_;
+    size_t chunk_free_ = 0;
+    char* chunk_pos_ = nullptr;
+
+    AppendArray<std::string_view> strings_;
+
+    // Ячейка общего индекса: дескриптор строки и старшие биты её хеша,
+    // по которым чужая строка отсеивается без сравнения
+    struct IndexSlot {
+        Handle handle = NO_HANDLE;
+        uint32_t fingerprint = 0;
+    };
+    static constexpr Handle NO_HANDLE = UINT32_MAX;
+
+    static uint64_t HashString(std::string_view str);
+    // Ячейка строки str или пустая ячейка, где она должна быть
+    size_t FindIndexSlot(std::string_view str, uint64_t hash) const;
+    void RebuildIndex(size_t capacity);
+
+    // Общий индекс строк — открытая адресация с линейным пробированием. Размер — степень
+    // двойки, заполнено не больше половины ячеек. При заморозке освобождается и строится
+    // заново, когда в пул добавляется новая строка
+    ChunkedArray<IndexSlot> index_;
+
+    // Запись замороженного индекса: дескриптор, длина и символы строки подряд. Проверка
+    // найденной строки читает одно место в памяти, а не ячейку и отдельно блок пула
+    static constexpr size_t FROZEN_RECORD_HEADER = sizeof(Handle) + sizeof(uint32_t);
+
+    struct FrozenSlot {
+        // Начало записи строки в records. Записи лежат в порядке позиций
+        uint32_t offset = 0;
+        // Младшие биты хеша строки: несовпадение отсеивает чужую строку без чтения записи
+        uint32_t fingerprint = 0;
+    };
+
+    // Замороженный индекс не меняется, поэтому копии пула делят его целиком
+    struct FrozenIndex {
+        PerfectHash hash;
+        // Ячейка строки — её позиция в hash
+        std::vector<FrozenSlot> slots;
+        std::vector<char> records;
+    };
+
+    void Unfreeze();
+
+    std::shared_ptr<const FrozenIndex> frozen_;
+};
+
+}
@@ -52,7 +52,7 @@ void Object::Render(const RenderContext& context) const {
     // Делегируем вывод тега своим подклассам
     RenderObject(context);
 
-    context.out << std::endl;
+    context.out << '\n';
 }
 
 // ---------- ObjectContainer ------------------
@@ -65,8 +65,8 @@ void Document::AddPtr(std::unique_ptr<Object> &&obj) {
     objects_.push_back(std::move(obj));
 }
 
-void Document::Render(std::ostream &out) const {
-    RenderContext context {out, 2, 2};
+void Document::Render(std::ostream &out, format::Precision precision) const {
+    RenderContext context {out, 2, 2, precision};
 
     out << R"(<?xml version="1.0" encoding="UTF-8" ?>)"sv << '\n';
     out << R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.1">)"sv << '\n';
@@ -92,9 +92,14 @@ Circle& Circle::SetRadius(double radius)  {
 
 void Circle::RenderObject(const RenderContext& context) const {
     auto& out = context.out;
-    out << "<circle cx=\""sv << center_.x << "\" cy=\""sv << center_.y << "\" "sv;
-    out << "r=\""sv << radius_ << "\""sv;
-    RenderAttrs(context.out);
+    out << "<circle cx=\""sv;
+    context.RenderNumber(center_.x);
+    out << "\" cy=\""sv;
+    context.RenderNumber(center_.y);
+    out << "\" r=\""sv;
+    context.RenderNumber(radius_);
+    out << "\""sv;
+    RenderAttrs(context);
     out << "/>"sv;
 }
 
@@ -111,16 +116,21 @@ void Polyline::RenderObject(const RenderContext &context) const {
 
     if (!points_.empty()) {
         const Point* point = &points_.at(0);
-        out << point->x << ',' << point->y;
+        context.RenderNumber(point->x);
+        out << ',';
+        context.RenderNumber(point->y);
         for (int i = 1; i < static_cast<int>(points_.size()); ++i) {
             point = &points_.at(i);
 
-            out << ' ' << point->x << ',' << point->y;
+            out << ' ';
+            context.RenderNumber(point->x);
+            out << ',';
+            context.RenderNumber(point->y);
         }
     }
 
     out << '"';
-    RenderAttrs(context.out);
+    RenderAttrs(context);
     out << "/>"sv;
 }
 
@@ -163,13 +173,17 @@ void Text::RenderObject(const RenderContext &context) const {
 
     out << "<text";
 
-    RenderAttrs(context.out);
+    RenderAttrs(context);
 
-    out << R"( x=")"sv << pos_.x << '"'
-        << R"( y=")"sv << pos_.y << '"'
-        << R"( dx=")"sv << offset_.x << '"'
-        << R"( dy=")"sv << offset_.y << '"'
-        << R"( font-size=")"sv << size_ << '"';
+    out << R"( x=")"sv;
+    context.RenderNumber(pos_.x);
+    out << R"(" y=")"sv;
+    context.RenderNumber(pos_.y);
+    out << R"(" dx=")"sv;
+    context.RenderNumber(offset_.x);
+    out << R"(" dy=")"sv;
+    context.RenderNumber(offset_.y);
+    out << R"(" font-size=")"sv << size_ << '"';
 
     if (!font_family_.empty()) {
         out << R"( font-family=")"sv << font_family_ << '"';
@@ -315,7 +329,7 @@ void ColorPrinter::operator()(Rgba rgba) const {
         << static_cast<int>(rgba.red) << ","sv
         << static_cast<int>(rgba.green) << ","sv
         << static_cast<int>(rgba.blue) << ","sv
-        << rgba.opacity
+        << format::FormattedDouble(rgba.opacity, precision).View()
         << ")"sv;
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "double_format.h"
+
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
@@ -29,6 +31,8 @@ inline const Color NoneColor{std::monostate{}};
 
 struct ColorPrinter {
     std::ostream& out;
+    // Точность вывода прозрачности rgba
+    format::Precision precision = format::Precision::Shortest();
 
     void operator()(std::monostate) const;
     void operator()(const std::string& str) const;
@@ -36,6 +40,8 @@ struct ColorPrinter {
     void operator()(Rgba rbga) const;
 };
 
+// Прозрачность выводится в кратчайшей записи. Внутри документа цвет выводится
+// через RenderContext::RenderColor с точностью, выбранной для документа
 std::ostream& operator<<(std::ostream& out, Color color);
 
 enum class StrokeLineCap {
@@ -67,21 +73,24 @@ struct Point {
 
 /*
  * Вспомогательная структура, хранящая контекст для вывода SVG-документа с отступами.
- * Хранит ссылку на поток вывода, текущее значение и шаг отступа при выводе элемента
+ * Хранит ссылку на поток вывода, текущее значение и шаг отступа при выводе элемента,
+ * а также точность вывода координат и размеров
  */
 struct RenderContext {
     RenderContext(std::ostream& out)
         : out(out) {
     }
 
-    RenderContext(std::ostream& out, int indent_step, int indent = 0)
+    RenderContext(std::ostream& out, int indent_step, int indent = 0,
+                  format::Precision precision = format::Precision::Shortest())
         : out(out)
         , indent_step(indent_step)
-        , indent(indent) {
+        , indent(indent)
+        , precision(precision) {
     }
 
     RenderContext Indented() const {
-        return {out, indent_step, indent + indent_step};
+        return {out, indent_step, indent + indent_step, precision};
     }
 
     void RenderIndent() const {
@@ -90,9 +99,18 @@ struct RenderContext {
         }
     }
 
+    void RenderNumber(double value) const {
+        out << format::FormattedDouble(value, precision).View();
+    }
+
+    void RenderColor(const Color& color) const {
+        std::visit(ColorPrinter{out, precision}, color);
+    }
+
     std::ostream& out;
     int indent_step = 0;
     int indent = 0;
+    format::Precision precision = format::Precision::Shortest();
 };
 
 
@@ -140,17 +158,24 @@ public:
     }
 protected:
     ~PathProps() = default;
-    void RenderAttrs(std::ostream& out) const {
+    void RenderAttrs(const RenderContext& context) const {
         using namespace std::literals;
+        auto& out = context.out;
 
         if (fill_color_) {
-            out << " fill=\""sv << *fill_color_ << "\""sv;
+            out << " fill=\""sv;
+            context.RenderColor(*fill_color_);
+            out << "\""sv;
         }
         if (stroke_color_) {
-            out << " stroke=\""sv << *stroke_color_ << "\""sv;
+            out << " stroke=\""sv;
+            context.RenderColor(*stroke_color_);
+            out << "\""sv;
         }
         if (stroke_width_) {
-            out << " stroke-width=\"" << *stroke_width_ << "\""sv;
+            out << " stroke-width=\""sv;
+            context.RenderNumber(*stroke_width_);
+            out << "\""sv;
         }
         if (stroke_line_cap_) {
             out << " stroke-linecap=\"" << *stroke_line_cap_ << "\"";
@@ -255,7 +280,8 @@ class Document : public ObjectContainer {
 public:
     void AddPtr(std::unique_ptr<Object>&& obj) override;
 
-    void Render(std::ostream& out) const;
+    // По умолчанию числа выводятся в кратчайшей записи без потери точности
+    void Render(std::ostream& out, format::Precision precision = format::Precision::Shortest()) const;
 private:
     std::vector<std::unique_ptr<Object>> objects_;
 };
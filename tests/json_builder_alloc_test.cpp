@@ -0,0 +1,99 @@
+// Проверяет, что json::Builder перемещает переданные по rvalue узлы без копирования:
+// счётчик из allocation_counter.h считает выделения и их объём, и на время вставки большого
+// значения они должны оставаться в пределах нескольких служебных узлов.
+// Для сравнения та же вставка по const& обязана скопировать значение целиком
+
+#include "json_builder.h"
+#include "benchmarks/allocation_counter.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using bench::AllocationStats;
+using bench::CountAllocations;
+
+constexpr size_t BIG_STRING_SIZE = 5 << 20;
+constexpr size_t ARRAY_SIZE = 1000;
+// Вставка перемещением создаёт не больше нескольких узлов словаря или массива
+constexpr size_t MAX_MOVE_ALLOCATIONS = 4;
+constexpr size_t MAX_MOVE_BYTES = 64 << 10;
+
+json::Node MakeArray() {
+    json::Array array;
+    array.reserve(ARRAY_SIZE);
+    for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+        array.emplace_back(std::string(64, 'a' + i % 26));
+    }
+    return json::Node{std::move(array)};
+}
+
+int failures = 0;
+
+void Check(bool condition, const std::string& name, AllocationStats stats) {
+    std::cout << (condition ? "ok   " : "FAIL ") << name << ": " << stats.count << " allocations, "
+              << stats.bytes << " bytes\n";
+    if (!condition) {
+        ++failures;
+    }
+}
+
+bool IsMove(AllocationStats stats) {
+    return stats.count <= MAX_MOVE_ALLOCATIONS && stats.bytes <= MAX_MOVE_BYTES;
+}
+
+}  // namespace
+
+int main() {
+    json::Builder builder;
+    json::Builder::DictRef root = builder.StartDict();
+
+    json::Node map{std::string(BIG_STRING_SIZE, 'm')};
+    const AllocationStats move_map = CountAllocations([&] {
+        root.Key("map").Value(std::move(map));
+    });
+    Check(IsMove(move_map), "KeyRef::Value(Node&&) with a 5 MiB string", move_map);
+
+    json::Node moved_array = MakeArray();
+    const AllocationStats move_array = CountAllocations([&] {
+        root.Key("moved").Value(std::move(moved_array));
+    });
+    Check(IsMove(move_array), "KeyRef::Value(Node&&) with a prebuilt array", move_array);
+
+    const json::Node copied_array = MakeArray();
+    const AllocationStats copy_array = CountAllocations([&] {
+        root.Key("copied").Value(copied_array);
+    });
+    Check(copy_array.count > ARRAY_SIZE, "KeyRef::Value(const Node&) copies the array", copy_array);
+
+    json::Builder::ArrayRef items = root.Key("items").StartArray();
+    json::Node item_string{std::string(BIG_STRING_SIZE, 'i')};
+    const AllocationStats move_item = CountAllocations([&] {
+        items.Value(std::move(item_string));
+    });
+    Check(IsMove(move_item), "ArrayRef::Value(Node&&) with a 5 MiB string", move_item);
+
+    json::Node item_array = MakeArray();
+    const AllocationStats move_item_array = CountAllocations([&] {
+        items.Value(std::move(item_array));
+    });
+    Check(IsMove(move_item_array), "ArrayRef::Value(Node&&) with a prebuilt array", move_item_array);
+    items.EndArray().EndDict();
+
+    json::Node document;
+    const AllocationStats build = CountAllocations([&] {
+        document = builder.Build();
+    });
+    Check(IsMove(build), "Build", build);
+
+    const json::Dict& result = document.AsDict();
+    const bool is_complete = result.at("map").AsString().size() == BIG_STRING_SIZE
+                             && result.at("moved").AsArray().size() == ARRAY_SIZE
+                             && result.at("copied").AsArray() == copied_array.AsArray()
+                             && result.at("items").AsArray().size() == 2;
+    Check(is_complete, "document content", {});
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,129 @@
+// Нагрузочная проверка VersionedCatalogue: читатели берут снимки и считают статистику,
+// пока писатель публикует версии. Каждая версия v отличается от начальной предсказуемо:
+// в ней есть остановки Added 1..v, а расстояние S0 → S1 увеличено на v. Читатель проверяет,
+// что снимок целиком соответствует своему номеру и что номера не убывают.
+// Запуск: versioned_catalogue_stress_test [updates] [readers]
+
+#include "versioned_catalogue.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace transport_catalogue;
+
+namespace {
+
+constexpr int RING_STOPS = 10;
+constexpr int BASE_DISTANCE = 100;
+constexpr int BASE_ROUTE_LENGTH = RING_STOPS * BASE_DISTANCE;
+
+// Названия собираются через append: на "S" + std::to_string GCC 12 с -O2 выдаёт ложное -Wrestrict
+std::string MakeStopTitle(int index) {
+    return std::string("S").append(std::to_string(index));
+}
+
+std::string MakeAddedTitle(uint64_t version) {
+    return std::string("Added ").append(std::to_string(version));
+}
+
+std::unique_ptr<TransportCatalogue> MakeInitialCatalogue() {
+    auto catalogue = std::make_unique<TransportCatalogue>();
+    std::vector<std::string> titles;
+    for (int i = 0; i < RING_STOPS; ++i) {
+        titles.push_back(MakeStopTitle(i));
+        catalogue->AddStop(titles.back(), {55.0 + i * 0.01, 37.0});
+    }
+    for (int i = 0; i < RING_STOPS; ++i) {
+        catalogue->SetStopsDistance(titles[i], titles[(i + 1) % RING_STOPS], BASE_DISTANCE);
+    }
+
+    std::vector<std::string_view> ring(titles.begin(), titles.end());
+    ring.push_back(titles.front());
+    catalogue->AddBus("Ring", ring, true);
+    return catalogue;
+}
+
+// Описание первого несоответствия снимка номеру версии или пустая строка
+std::string CheckSnapshot(const VersionedCatalogue::Snapshot& snapshot) {
+    const uint64_t version = snapshot.version;
+    if (snapshot->GetStopsCount() != RING_STOPS + version) {
+        return "stops count";
+    }
+    if (version > 0 && !snapshot->FindStop(MakeAddedTitle(version))) {
+        return "missing last added stop";
+    }
+    if (snapshot->FindStop(MakeAddedTitle(version + 1))) {
+        return "stop from a later version";
+    }
+    const std::optional<BusStats> stats = snapshot->GetBusStats("Ring");
+    if (!stats || stats->route_length != BASE_ROUTE_LENGTH + static_cast<int>(version)) {
+        return "route length";
+    }
+    return {};
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int updates = argc > 1 ? std::atoi(argv[1]) : 500;
+    const int readers_count = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    VersionedCatalogue catalogue(MakeInitialCatalogue());
+    const VersionedCatalogue::Snapshot initial = catalogue.GetSnapshot();
+
+    std::atomic<bool> done = false;
+    std::atomic<int> failures = 0;
+    std::atomic<uint64_t> snapshots_checked = 0;
+
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < readers_count; ++reader) {
+        readers.emplace_back([&] {
+            uint64_t last_version = 0;
+            uint64_t checked = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const VersionedCatalogue::Snapshot snapshot = catalogue.GetSnapshot();
+                const std::string error = CheckSnapshot(snapshot);
+                if (!error.empty() || snapshot.version < last_version) {
+                    if (failures++ == 0) {
+                        std::cerr << "version " << snapshot.version << ": "
+                                  << (error.empty() ? "version went back" : error) << '\n';
+                    }
+                }
+                last_version = snapshot.version;
+                ++checked;
+            }
+            snapshots_checked += checked;
+        });
+    }
+
+    // Писатель копирует версии, статистику которых в это время считают читатели
+    for (int update = 1; update <= updates; ++update) {
+        const uint64_t published = catalogue.Update([update](TransportCatalogue& next) {
+            next.AddStop(MakeAddedTitle(update), {56.0, 38.0});
+            next.SetStopsDistance(MakeStopTitle(0), MakeStopTitle(1), BASE_DISTANCE + update);
+        });
+        if (published != static_cast<uint64_t>(update)) {
+            std::cerr << "Update returned version " << published << " instead of " << update << '\n';
+            ++failures;
+        }
+    }
+
+    done.store(true, std::memory_order_release);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    // Снимок, взятый до всех обновлений, не должен был измениться
+    if (!CheckSnapshot(initial).empty() || !CheckSnapshot(catalogue.GetSnapshot()).empty()) {
+        std::cerr << "first or last snapshot is inconsistent\n";
+        ++failures;
+    }
+
+    std::cout << updates << " updates, " << readers_count << " readers, "
+              << snapshots_checked.load() << " snapshots checked, " << failures.load() << " failures\n";
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,118 +1,472 @@
 #include "transport_catalogue.h"
 #include "geo.h"
+#include "parallel.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
-#include <unordered_set>
 
 namespace transport_catalogue {
 
-void TransportCatalogue::AddStop(std::string_view title, geo::Coordinates coords) {
-    const Stop* stop = &*stops_.insert(stops_.end(), {std::string(title), coords});
-    stops_index_.insert({stop->title, stop});
-    stop_to_buses_.insert({stop->title, {}});
+TransportCatalogue::TransportCatalogue() {
+    bus_stops_begin_.PushBack(0);
+}
+
+TransportCatalogue::TransportCatalogue(const TransportCatalogue& other)
+    : names_(other.names_)
+    , stop_titles_(other.stop_titles_)
+    , stop_coords_(other.stop_coords_)
+    , stop_points_(other.stop_points_)
+    , stop_buses_(other.stop_buses_)
+    , spatial_index_(other.spatial_index_)
+    , bus_titles_(other.bus_titles_)
+    , bus_stops_begin_(other.bus_stops_begin_)
+    , bus_stops_(other.bus_stops_)
+    , bus_is_roundtrip_(other.bus_is_roundtrip_)
+    , bus_stats_(other.bus_stats_)
+    , has_shadowed_buses_(other.has_shadowed_buses_)
+    , stops_index_(other.stops_index_)
+    , buses_index_(other.buses_index_)
+    , stops_to_distance_(other.stops_to_distance_) {
+    // Общие индекс и статистику могут в любой момент заполнить читатели оригинала,
+    // поэтому копия считает их заполненными и сбрасывает при изменениях
+    has_spatial_index_.store(true, std::memory_order_relaxed);
+    has_cached_stats_.store(GetBusesCount() > 0, std::memory_order_relaxed);
+}
+
+TransportCatalogue::CachedBusStats::CachedBusStats(const CachedBusStats& other) {
+    if (other.ready.load(std::memory_order_acquire)) {
+        stats = other.stats;
+        ready.store(true, std::memory_order_relaxed);
+    }
+}
+
+StopId TransportCatalogue::AddStop(std::string_view title, geo::Coordinates coords) {
+    const StopId id = static_cast<StopId>(stop_coords_.size());
+
+    const StringPool::Handle handle = names_.Intern(title);
+    stop_titles_.PushBack(handle);
+    stop_coords_.PushBack(coords);
+    stop_points_.PushBack(geo::ToSpherePoint(coords));
+    stop_buses_.EmplaceBack();
+    IndexName(stops_index_, handle, id);
+
+    if (has_spatial_index_.load(std::memory_order_relaxed)) {
+        spatial_index_ = std::make_shared<LazySpatialIndex>();
+        has_spatial_index_.store(false, std::memory_order_relaxed);
+    }
+
+    return id;
 }
 
 void TransportCatalogue::SetStopsDistance(std::string_view from,
                                           std::string_view to,
                                           int distance) {
 
-    stops_to_distance_[{std::string(from), std::string(to)}] = distance;
+    // Расстояние до остановки, которой нет в справочнике, никогда не понадобится
+    const std::optional<StopId> from_id = FindStop(from);
+    const std::optional<StopId> to_id = FindStop(to);
+    if (!from_id || !to_id) {
+        return;
+    }
+
+    SetStopsDistance(*from_id, *to_id, distance);
 }
 
-void TransportCatalogue::AddBus(std::string_view title, const std::vector<std::string_view> &stops, bool is_roundtrip) {
-    Bus& bus = *buses_.insert(buses_.end(), Bus{});
+void TransportCatalogue::SetStopsDistance(StopId from, StopId to, int distance) {
+    stops_to_distance_.Set(from, to, distance);
+    // Маршрут с отрезком from → to или to → from обязательно проходит через from
+    ResetBusStats(from);
+}
 
-    bus.title = title;
-    bus.is_roundtrip = is_roundtrip;
-    buses_index_.insert({bus.title, &bus});
+BusId TransportCatalogue::AddBus(std::string_view title, const std::vector<std::string_view> &stops, bool is_roundtrip) {
+    const BusId id = static_cast<BusId>(bus_is_roundtrip_.size());
 
+    // Сначала находим все остановки, чтобы при ошибке справочник остался прежним
+    std::vector<StopId> resolved_stops;
+    resolved_stops.reserve(stops.size());
     for (std::string_view stop_title : stops) {
-        const Stop& stop = *stops_index_.at(std::string(stop_title));
-        bus.stops.push_back(&stop);
-        stop_to_buses_[stop.title].insert(&bus);
+        const std::optional<StopId> stop = FindStop(stop_title);
+        if (!stop) {
+            throw std::out_of_range{"Unknown stop"};
+        }
+        resolved_stops.push_back(*stop);
+    }
+    bus_stops_.Append(resolved_stops);
+
+    const StringPool::Handle handle = names_.Intern(title);
+    bus_titles_.PushBack(handle);
+    bus_stops_begin_.PushBack(static_cast<uint32_t>(bus_stops_.size()));
+    bus_is_roundtrip_.PushBack(is_roundtrip);
+    bus_stats_.EmplaceBack();
+    if (!IndexName(buses_index_, handle, id)) {
+        has_shadowed_buses_ = true;
+    }
+
+    // Списки маршрутов остановок поддерживаются упорядоченными по названию,
+    // чтобы запрос об остановке выводил их без сортировки
+    const std::string_view bus_title = names_.Get(handle);
+    for (StopId stop : resolved_stops) {
+        std::vector<BusId>& buses = stop_buses_.Mutable(stop);
+        auto it = std::lower_bound(buses.begin(), buses.end(), bus_title, [this](BusId bus, std::string_view title) {
+            return names_.Get(bus_titles_[bus]) < title;
+        });
+        if (it == buses.end() || names_.Get(bus_titles_[*it]) != bus_title) {
+            buses.insert(it, id);
+        }
     }
+
+    return id;
 }
 
-const Bus* TransportCatalogue::GetBus(std::string_view title) const {
-    auto bus_it = buses_index_.find(title);
+void TransportCatalogue::AddBulk(const BulkData& data, unsigned threads) {
+    if (threads == 0) {
+        threads = GetDefaultThreadCount();
+    }
+
+    const size_t names_count = names_.Size() + data.stops.size() + data.buses.size();
+    names_.Reserve(names_count);
+    stops_index_.Reserve(names_count);
+    buses_index_.Reserve(names_count);
+
+    // Остановки дёшево дописываются в конец массивов, параллелить здесь нечего
+    stop_titles_.Reserve(stop_titles_.size() + data.stops.size());
+    stop_coords_.Reserve(stop_coords_.size() + data.stops.size());
+    stop_points_.Reserve(stop_points_.size() + data.stops.size());
+    stop_buses_.Reserve(stop_buses_.size() + data.stops.size());
+    for (const StopData& stop : data.stops) {
+        AddStop(stop.title, stop.coords);
+    }
+
+    // Названия остановок маршрутов и расстояний переводятся в идентификаторы параллельно.
+    // Остановки маршрута bus окажутся в resolved_stops начиная с resolved_begin[bus]
+    std::vector<size_t> resolved_begin(data.buses.size() + 1, 0);
+    for (size_t bus = 0; bus < data.buses.size(); ++bus) {
+        resolved_begin[bus + 1] = resolved_begin[bus] + data.buses[bus].stops.size();
+    }
+    std::vector<StopId> resolved_stops(resolved_begin.back());
+    // Расстояния до неизвестных остановок пропускаются, как в SetStopsDistance по названиям
+    constexpr StopId UNKNOWN_STOP = std::numeric_limits<StopId>::max();
+    std::vector<std::pair<StopId, StopId>> resolved_distances(data.distances.size(), {UNKNOWN_STOP, UNKNOWN_STOP});
+
+    auto resolve = [this](std::string_view title) {
+        const std::optional<StopId> stop = FindStop(title);
+        if (!stop) {
+            throw std::out_of_range{"Unknown stop"};
+        }
+        return *stop;
+    };
+
+    RunParallel(threads, [&](unsigned part) {
+        const auto [buses_begin, buses_end] = PartRange(data.buses.size(), threads, part);
+        for (size_t bus = buses_begin; bus < buses_end; ++bus) {
+            StopId* out = resolved_stops.data() + resolved_begin[bus];
+            for (std::string_view stop_title : data.buses[bus].stops) {
+                *out++ = resolve(stop_title);
+            }
+        }
+
+        const auto [distances_begin, distances_end] = PartRange(data.distances.size(), threads, part);
+        for (size_t i = distances_begin; i < distances_end; ++i) {
+            const std::optional<StopId> from = FindStop(data.distances[i].from);
+            const std::optional<StopId> to = FindStop(data.distances[i].to);
+            if (from && to) {
+                resolved_distances[i] = {*from, *to};
+            }
+        }
+    });
+
+    // Порядок записи расстояний важен: при повторе пары побеждает последнее
+    stops_to_distance_.Reserve(stops_to_distance_.Size() + data.distances.size());
+    for (size_t i = 0; i < data.distances.size(); ++i) {
+        if (resolved_distances[i].first == UNKNOWN_STOP) {
+            continue;
+        }
+        SetStopsDistance(resolved_distances[i].first, resolved_distances[i].second, data.distances[i].distance);
+    }
 
-    if (bus_it != buses_index_.end()) {
-        return nullptr;
+    const BusId first_bus = static_cast<BusId>(GetBusesCount());
+    const size_t first_stop = bus_stops_.size();
+    bus_stops_.Append(resolved_stops);
+    bus_titles_.Reserve(bus_titles_.size() + data.buses.size());
+    bus_stops_begin_.Reserve(bus_stops_begin_.size() + data.buses.size());
+    bus_is_roundtrip_.Reserve(bus_is_roundtrip_.size() + data.buses.size());
+    bus_stats_.Reserve(bus_stats_.size() + data.buses.size());
+    for (size_t bus = 0; bus < data.buses.size(); ++bus) {
+        const StringPool::Handle handle = names_.Intern(data.buses[bus].title);
+        bus_titles_.PushBack(handle);
+        bus_stops_begin_.PushBack(static_cast<uint32_t>(first_stop + resolved_begin[bus + 1]));
+        bus_is_roundtrip_.PushBack(data.buses[bus].is_roundtrip);
+        bus_stats_.EmplaceBack();
+        if (!IndexName(buses_index_, handle, first_bus + static_cast<BusId>(bus))) {
+            has_shadowed_buses_ = true;
+        }
     }
 
-    return bus_it->second;
+    // Обратный индекс. Сначала каждый поток раскладывает пары (остановка, маршрут) из своей
+    // части маршрутов по владельцам остановок, затем каждый владелец собирает свои списки
+    std::vector<std::vector<std::vector<std::pair<StopId, BusId>>>> buckets(threads);
+    RunParallel(threads, [&](unsigned part) {
+        buckets[part].resize(threads);
+        const auto [buses_begin, buses_end] = PartRange(data.buses.size(), threads, part);
+        for (size_t bus = buses_begin; bus < buses_end; ++bus) {
+            const BusId id = first_bus + static_cast<BusId>(bus);
+            for (size_t i = resolved_begin[bus]; i < resolved_begin[bus + 1]; ++i) {
+                buckets[part][resolved_stops[i] % threads].emplace_back(resolved_stops[i], id);
+            }
+        }
+    });
+
+    // Блоки списков, общие с другими версиями справочника, копируются заранее:
+    // владельцы меняют списки параллельно и не должны подменять блоки друг друга
+    for (StopId stop : resolved_stops) {
+        stop_buses_.Mutable(stop);
+    }
+
+    auto bus_title = [this](BusId bus) {
+        return names_.Get(bus_titles_[bus]);
+    };
+    RunParallel(threads, [&](unsigned owner) {
+        std::vector<StopId> touched_stops;
+        // Размеры списков до добавления. У владельца только остановки с stop % threads == owner
+        std::vector<size_t> old_sizes(stop_buses_.size() / threads + 1, SIZE_MAX);
+
+        // Части перебираются по порядку, поэтому маршруты каждой остановки идут по возрастанию id
+        for (unsigned part = 0; part < threads; ++part) {
+            for (const auto& [stop, bus] : buckets[part][owner]) {
+                std::vector<BusId>& buses = stop_buses_.Mutable(stop);
+                size_t& old_size = old_sizes[stop / threads];
+                if (old_size == SIZE_MAX) {
+                    old_size = buses.size();
+                    touched_stops.push_back(stop);
+                }
+                if (buses.size() == old_size || buses.back() != bus) {
+                    buses.push_back(bus);
+                }
+            }
+        }
+
+        // Как и в AddBus: список упорядочен по названию, из одноимённых маршрутов
+        // остаётся добавленный раньше
+        for (StopId stop : touched_stops) {
+            std::vector<BusId>& buses = stop_buses_.Mutable(stop);
+            const auto middle = buses.begin() + old_sizes[stop / threads];
+            auto by_title = [&bus_title](BusId lhs, BusId rhs) {
+                return bus_title(lhs) < bus_title(rhs);
+            };
+            std::stable_sort(middle, buses.end(), by_title);
+            std::inplace_merge(buses.begin(), middle, buses.end(), by_title);
+            buses.erase(std::unique(buses.begin(), buses.end(), [&bus_title](BusId lhs, BusId rhs) {
+                return bus_title(lhs) == bus_title(rhs);
+            }), buses.end());
+        }
+    });
 }
 
-std::optional<BusStats> TransportCatalogue::GetBusStats(std::string_view title) const {
-    auto bus_it = buses_index_.find(title);
+std::optional<StopId> TransportCatalogue::FindStop(std::string_view title) const {
+    return FindByName(stops_index_, names_.Find(title));
+}
+
+std::optional<BusId> TransportCatalogue::FindBus(std::string_view title) const {
+    return FindByName(buses_index_, names_.Find(title));
+}
+
+Stop TransportCatalogue::GetStop(StopId id) const {
+    return {id, names_.Get(stop_titles_[id]), stop_coords_[id]};
+}
+
+Bus TransportCatalogue::GetBus(BusId id) const {
+    const std::span<const StopId> stops(bus_stops_.data() + bus_stops_begin_[id],
+                                        bus_stops_begin_[id + 1] - bus_stops_begin_[id]);
+    return {id, names_.Get(bus_titles_[id]), stops, bus_is_roundtrip_[id]};
+}
+
+std::optional<Stop> TransportCatalogue::GetStop(std::string_view title) const {
+    if (auto id = FindStop(title)) {
+        return GetStop(*id);
+    }
 
-    if (bus_it != buses_index_.end()) {
-        return  std::nullopt;
+    return std::nullopt;
+}
+
+std::optional<Bus> TransportCatalogue::GetBus(std::string_view title) const {
+    if (auto id = FindBus(title)) {
+        return GetBus(*id);
     }
 
-    const Bus* bus = bus_it->second;
-    std::vector<const Stop*> stops = bus->stops;
+    return std::nullopt;
+}
+
+BusStats TransportCatalogue::GetBusStats(BusId id) const {
+    const CachedBusStats& cached = bus_stats_[id];
+    if (cached.ready.load(std::memory_order_acquire)) {
+        return cached.stats;
+    }
+
+    std::call_once(cached.computed, [this, id, &cached] {
+        cached.stats = ComputeBusStats(id);
+        cached.ready.store(true, std::memory_order_release);
+        has_cached_stats_.store(true, std::memory_order_relaxed);
+    });
+
+    return cached.stats;
+}
+
+BusStats TransportCatalogue::ComputeBusStats(BusId id) const {
+    const std::span<const StopId> stops = GetBus(id).stops;
 
     if(stops.size() == 1) {
-        return BusStats{1, 1, 0, std::nan("")};
+        return BusStats{1, 1, 0, 0, std::nan("")};
     } else if (stops.size() == 0) {
         return {};
     }
 
-    double geo_length = 0;
+    BusStats stats;
 
-    std::unordered_set<std::string_view> uniq_stops;
-    uniq_stops.reserve(stops.size());
+    stats.geo_length = geo::ComputeRouteLength(stop_points_, stops);
+    for (size_t i = 0; i + 1 < stops.size(); ++i) {
+        stats.route_length += GetDistance(stops[i], stops[i + 1]);
+    }
 
-    BusStats stats;
+    // Последняя остановка маршрута совпадает с первой, поэтому в подсчёт не входит
+    std::vector<StopId> uniq_stops(stops.begin(), stops.end() - 1);
+    std::sort(uniq_stops.begin(), uniq_stops.end());
 
-    for (int i = 0; i < static_cast<int>(stops.size()) - 1; ++i) {
-        uniq_stops.insert(stops[i]->title);
+    stats.stops_amount = stops.size();
+
+    stats.uniq_stops_amount = std::unique(uniq_stops.begin(), uniq_stops.end()) - uniq_stops.begin();
+    stats.curvature = stats.route_length / stats.geo_length;
+
+    return stats;
+}
 
-        geo_length += ComputeDistance(stops[i]->coords, stops[i+1]->coords);
-        stats.route_length += GetDistance(stops[i]->title, stops[i+1]->title);
+bool TransportCatalogue::IndexName(ChunkedArray<uint32_t>& index, StringPool::Handle handle, uint32_t id) {
+    if (handle >= index.size()) {
+        index.Resize(handle + 1, NO_ID);
+    }
+    if (index[handle] != NO_ID) {
+        return false;
     }
 
-    stats.stops_amount = bus->stops.size();
+    index.Mutable(handle) = id;
+    return true;
+}
 
-    stats.uniq_stops_amount = uniq_stops.size();
-    stats.curvature = stats.route_length / geo_length;
+std::optional<uint32_t> TransportCatalogue::FindByName(const ChunkedArray<uint32_t>& index,
+                                                       std::optional<StringPool::Handle> handle) {
+    if (!handle || *handle >= index.size() || index[*handle] == NO_ID) {
+        return std::nullopt;
+    }
 
-    return stats;
+    return index[*handle];
 }
 
-const std::unordered_set<const Bus*>&
-TransportCatalogue::GetBusesOfStop(std::string_view title) const {
-    return stop_to_buses_.at(title);
+void TransportCatalogue::ResetBusStats(StopId stop) {
+    // Пока данные загружаются, статистику никто не запрашивал и сбрасывать нечего
+    if (!has_cached_stats_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    if (has_shadowed_buses_) {
+        ChunkedArray<CachedBusStats> bus_stats;
+        bus_stats.Reserve(bus_stats_.size());
+        while (bus_stats.size() < bus_stats_.size()) {
+            bus_stats.EmplaceBack();
+        }
+        bus_stats_ = std::move(bus_stats);
+        has_cached_stats_.store(false, std::memory_order_relaxed);
+        return;
+    }
+
+    // Изменение справочника не совпадает по времени с чтением, поэтому once_flag
+    // можно пересоздать на месте. Общий с другими версиями блок Mutable сначала копирует
+    for (BusId bus : stop_buses_[stop]) {
+        CachedBusStats& cached = bus_stats_.Mutable(bus);
+        std::destroy_at(&cached);
+        std::construct_at(&cached);
+    }
 }
 
-const Stop* TransportCatalogue::GetStop(std::string_view title) const {
-    auto stop_it = stops_index_.find(title);
+std::optional<BusStats> TransportCatalogue::GetBusStats(std::string_view title) const {
+    if (auto id = FindBus(title)) {
+        return GetBusStats(*id);
+    }
 
-    if (stop_it == stops_index_.end()) {
-        return nullptr;
+    return std::nullopt;
+}
+
+std::span<const BusId> TransportCatalogue::GetBusesOfStop(StopId id) const {
+    return stop_buses_[id];
+}
+
+std::span<const BusId> TransportCatalogue::GetBusesOfStop(std::string_view title) const {
+    const std::optional<StopId> stop = FindStop(title);
+    if (!stop) {
+        throw std::out_of_range{"Unknown stop"};
     }
 
-    return stop_it->second;
+    return GetBusesOfStop(*stop);
+}
+
+size_t TransportCatalogue::GetStopsCount() const {
+    return stop_coords_.size();
+}
+
+size_t TransportCatalogue::GetBusesCount() const {
+    return bus_is_roundtrip_.size();
+}
+
+std::span<const geo::Coordinates> TransportCatalogue::GetStopsCoordinates() const {
+    return stop_coords_;
+}
+
+std::vector<StopId> TransportCatalogue::FindNearestStops(geo::Coordinates center, size_t count) const {
+    return GetSpatialIndex().FindNearest(center, count);
 }
 
-const std::deque<Stop>& TransportCatalogue::GetStops() {
-    return stops_;
+std::vector<StopId> TransportCatalogue::FindStopsWithinRadius(geo::Coordinates center, double radius) const {
+    return GetSpatialIndex().FindWithinRadius(center, radius);
 }
 
-const std::deque<Bus>& TransportCatalogue::GetBuses() {
-    return buses_;
+std::vector<StopId> TransportCatalogue::FindStopsInBox(geo::Coordinates south_west,
+                                                       geo::Coordinates north_east) const {
+    return GetSpatialIndex().FindInBox(south_west, north_east);
+}
+
+const geo::SpatialIndex& TransportCatalogue::GetSpatialIndex() const {
+    LazySpatialIndex& lazy = *spatial_index_;
+    std::call_once(lazy.built, [this, &lazy] {
+        lazy.index = geo::SpatialIndex(stop_coords_);
+        has_spatial_index_.store(true, std::memory_order_relaxed);
+    });
+
+    return lazy.index;
+}
+
+void TransportCatalogue::Freeze() {
+    names_.Freeze();
+}
+
+int TransportCatalogue::GetDistance(std::string_view from, std::string_view to) const {
+    const std::optional<StopId> from_id = FindStop(from);
+    const std::optional<StopId> to_id = FindStop(to);
+
+    if (!from_id || !to_id) {
+        throw std::out_of_range{"Can't find distance"};
+    }
+
+    return GetDistance(*from_id, *to_id);
 }
 
-int TransportCatalogue::GetDistance(const std::string& from, const std::string& to) const
+int TransportCatalogue::GetDistance(StopId from, StopId to) const
 {
-    if (stops_to_distance_.contains({from, to})) {
-        return stops_to_distance_.at({from, to});
+    if (auto distance = stops_to_distance_.Find(from, to)) {
+        return *distance;
     } else if (from == to) {
         return 0;
-    } else if (stops_to_distance_.contains({to, from})) {
-        return stops_to_distance_.at({to, from});
+    } else if (auto distance = stops_to_distance_.Find(to, from)) {
+        return *distance;
     } else {
         throw std::out_of_range{"Can't find distance"};
     }
@@ -2,41 +2,183 @@
 
 #include "geo.h"
 #include "domain.h"
+#include "distance_table.h"
+#include "string_pool.h"
+#include "spatial_index.h"
+#include "shared_arrays.h"
 
 #include <vector>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
-#include <deque>
 #include <optional>
+#include <mutex>
+#include <atomic>
+#include <span>
+#include <memory>
 
 namespace transport_catalogue {
+    /*
+     * Данные хранятся по столбцам в плоских массивах, индексом служит StopId или BusId.
+     * Поиск по названию — тонкая надстройка, которая переводит название в идентификатор
+     */
     class TransportCatalogue {
     public:
-        void AddStop(std::string_view title, geo::Coordinates coords);
+        TransportCatalogue();
 
+        // Копия делит с оригиналом все столбцы, посчитанную статистику и пространственный
+        // индекс и стоит порядка числа остановок и маршрутов, делённого на тысячу. Изменения
+        // копии не видны в оригинале: изменённые блоки столбцов копируются при первой записи.
+        // Копировать можно неизменяемый справочник, который одновременно читают другие потоки
+        TransportCatalogue(const TransportCatalogue& other);
+        TransportCatalogue& operator=(const TransportCatalogue&) = delete;
+
+        StopId AddStop(std::string_view title, geo::Coordinates coords);
+
+        // Если какой-то из остановок ещё нет в справочнике, расстояние не запоминается
         void SetStopsDistance(std::string_view from, std::string_view to, int distance);
+        void SetStopsDistance(StopId from, StopId to, int distance);
+
+        BusId AddBus(std::string_view title, const std::vector<std::string_view>& stops, bool is_roundtrip);
+
+        struct StopData {
+            std::string_view title;
+            geo::Coordinates coords;
+        };
+
+        struct DistanceData {
+            std::string_view from;
+            std::string_view to;
+            int distance = 0;
+        };
+
+        struct BusData {
+            std::string_view title;
+            // Остановки в том виде, в каком их принимает AddBus
+            std::vector<std::string_view> stops;
+            bool is_roundtrip = false;
+        };
 
-        void AddBus(std::string_view title, const std::vector<std::string_view>& stops, bool is_roundtrip);
+        struct BulkData {
+            std::vector<StopData> stops;
+            std::vector<DistanceData> distances;
+            std::vector<BusData> buses;
+        };
 
-        int GetDistance(const std::string& from, const std::string& to) const;
+        /*
+         * Добавляет всё сразу. Результат тот же, что у последовательных AddStop для всех
+         * остановок, SetStopsDistance для всех расстояний и AddBus для всех маршрутов.
+         * Поиск остановок по названиям и обратный индекс остановка → маршруты строятся
+         * в threads потоках (0 — по числу ядер). Расстояния до неизвестных остановок
+         * пропускаются. Если не найдена какая-то остановка маршрута, выбрасывается
+         * std::out_of_range, а расстояния и маршруты не добавляются
+         */
+        void AddBulk(const BulkData& data, unsigned threads = 0);
 
-        const Bus* GetBus(std::string_view title) const;
+        // Готовит справочник к поиску по названиям после загрузки: строит минимальную
+        // совершенную хеш-функцию по названиям. Последующие изменения допустимы, но поиск
+        // по названиям снова идёт через общий индекс до следующего Freeze
+        void Freeze();
+
+        int GetDistance(std::string_view from, std::string_view to) const;
+        int GetDistance(StopId from, StopId to) const;
+
+        std::optional<StopId> FindStop(std::string_view title) const;
+        std::optional<BusId> FindBus(std::string_view title) const;
+
+        Stop GetStop(StopId id) const;
+        Bus GetBus(BusId id) const;
+        std::optional<Stop> GetStop(std::string_view title) const;
+        std::optional<Bus> GetBus(std::string_view title) const;
+
+        // Статистика маршрута считается при первом запросе и запоминается.
+        // Одновременные запросы из нескольких потоков безопасны
+        BusStats GetBusStats(BusId id) const;
         std::optional<BusStats> GetBusStats(std::string_view title) const;
-        const std::unordered_set<const Bus*>& GetBusesOfStop(std::string_view title) const;
-        const Stop* GetStop(std::string_view title) const;
 
-        const std::deque<Stop>& GetStops();
-        const std::deque<Bus>& GetBuses();
+        // Маршруты, проходящие через остановку, упорядоченные по названию.
+        // Маршруты с одинаковым названием входят в список один раз
+        std::span<const BusId> GetBusesOfStop(StopId id) const;
+        std::span<const BusId> GetBusesOfStop(std::string_view title) const;
+
+        size_t GetStopsCount() const;
+        size_t GetBusesCount() const;
+
+        // Координаты всех остановок, индекс — StopId
+        std::span<const geo::Coordinates> GetStopsCoordinates() const;
+
+        // Поиск остановок вокруг точки. Пространственный индекс строится при первом
+        // таком запросе и перестраивается после добавления остановок
+        std::vector<StopId> FindNearestStops(geo::Coordinates center, size_t count) const;
+        std::vector<StopId> FindStopsWithinRadius(geo::Coordinates center, double radius) const;
+        std::vector<StopId> FindStopsInBox(geo::Coordinates south_west, geo::Coordinates north_east) const;
     private:
-        std::deque<Stop> stops_;
-        std::deque<Bus> buses_;
+        struct LazySpatialIndex {
+            std::once_flag built;
+            geo::SpatialIndex index;
+        };
+
+        const geo::SpatialIndex& GetSpatialIndex() const;
+
+        // Блок статистики бывает общим у нескольких версий справочника и заполняется
+        // при чтении любой из них, поэтому поля mutable
+        struct CachedBusStats {
+            CachedBusStats() = default;
+            // Копируется только готовая статистика: исходную в это время могут считать другие потоки
+            CachedBusStats(const CachedBusStats& other);
+            CachedBusStats& operator=(const CachedBusStats&) = delete;
+
+            mutable std::once_flag computed;
+            // Выставляется после записи stats, чтобы прочитать готовую статистику без call_once
+            mutable std::atomic<bool> ready = false;
+            mutable BusStats stats;
+        };
+
+        BusStats ComputeBusStats(BusId id) const;
+        // Сбрасывает посчитанную статистику маршрутов, которые проходят через stop:
+        // только их длину меняет расстояние от этой остановки или до неё
+        void ResetBusStats(StopId stop);
+
+        // Идентификатор, которого нет ни у одной остановки и ни у одного маршрута
+        static constexpr uint32_t NO_ID = UINT32_MAX;
+
+        // Запоминает, что название handle принадлежит объекту id.
+        // При повторе названия остаётся первый объект, тогда возвращается false
+        static bool IndexName(ChunkedArray<uint32_t>& index, StringPool::Handle handle, uint32_t id);
+        static std::optional<uint32_t> FindByName(const ChunkedArray<uint32_t>& index,
+                                                  std::optional<StringPool::Handle> handle);
+
+        // Все названия остановок и маршрутов хранятся в пуле по одному разу
+        StringPool names_;
+
+        // Остановки. Столбцы, в которые только дописывают, — AppendArray,
+        // столбцы с изменяемыми элементами — ChunkedArray
+        AppendArray<StringPool::Handle> stop_titles_;
+        AppendArray<geo::Coordinates> stop_coords_;
+        // Те же координаты на единичной сфере для расчёта длины маршрутов
+        AppendArray<geo::SpherePoint> stop_points_;
+        ChunkedArray<std::vector<BusId>> stop_buses_;
+        // Индекс общий с копиями, пока в них не добавят остановки
+        mutable std::shared_ptr<LazySpatialIndex> spatial_index_ = std::make_shared<LazySpatialIndex>();
+        mutable std::atomic<bool> has_spatial_index_ = false;
+
+        // Маршруты. Остановки всех маршрутов лежат подряд в bus_stops_,
+        // маршрут id занимает отрезок [bus_stops_begin_[id], bus_stops_begin_[id + 1])
+        AppendArray<StringPool::Handle> bus_titles_;
+        AppendArray<uint32_t> bus_stops_begin_;
+        AppendArray<StopId> bus_stops_;
+        AppendArray<bool> bus_is_roundtrip_;
+        // once_flag нельзя перемещать. ChunkedArray элементы не перемещает,
+        // а общий блок копирует через конструктор копирования CachedBusStats
+        ChunkedArray<CachedBusStats> bus_stats_;
+        mutable std::atomic<bool> has_cached_stats_ = false;
+        // Есть маршруты с повторяющимся названием. Их нет в stop_buses_,
+        // поэтому сбросить статистику только части маршрутов нельзя
+        bool has_shadowed_buses_ = false;
 
-        std::unordered_map<std::string_view, const Stop*> stops_index_;
-        std::unordered_map<std::string_view, const Bus*> buses_index_;
+        // Остановка и маршрут по дескриптору названия, NO_ID — такого нет
+        ChunkedArray<StopId> stops_index_;
+        ChunkedArray<BusId> buses_index_;
 
-        std::unordered_map<std::string_view, std::unordered_set<const Bus*>> stop_to_buses_;
-        std::unordered_map<std::pair<std::string, std::string>, int, PairHash> stops_to_distance_;
+        DistanceTable stops_to_distance_;
     };
 }
 
@@ -0,0 +1,924 @@
+#include "transport_router.h"
+#include "mapped_file.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+
+namespace transport_catalogue {
+
+namespace {
+
+constexpr double UNREACHED = std::numeric_limits<double>::infinity();
+// Ребро, по которому пришли в начальную вершину
+constexpr uint32_t NO_EDGE = UINT32_MAX;
+constexpr uint32_t NOT_IN_HEAP = UINT32_MAX;
+// Сколько вершин просматривает поиск свидетеля при сжатии. Больше — меньше лишних
+// сокращений, но дольше построение. Для оценки приоритета хватает грубого поиска
+constexpr size_t WITNESS_SETTLED_LIMIT = 64;
+constexpr size_t PRIORITY_WITNESS_SETTLED_LIMIT = 16;
+
+// Накопительная контрольная сумма: каждое слово смешивается с состоянием одним 128-битным умножением
+class Checksum {
+public:
+    void Add(uint64_t value) {
+        const unsigned __int128 product = static_cast<unsigned __int128>(state_ ^ value) * 0x9e3779b97f4a7c15ULL;
+        state_ = static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+    }
+
+    void AddBytes(const char* data, size_t size) {
+        Add(size);
+        for (; size >= 8; data += 8, size -= 8) {
+            uint64_t word;
+            std::memcpy(&word, data, 8);
+            Add(word);
+        }
+        if (size > 0) {
+            uint64_t word = 0;
+            std::memcpy(&word, data, size);
+            Add(word);
+        }
+    }
+
+    uint64_t Get() const {
+        return state_;
+    }
+
+private:
+    uint64_t state_ = 0x243f6a8885a308d3ULL;
+};
+
+// Файл Save: заголовок, затем массивы из ForEachArray, каждый с границы 8 байт.
+// Массивы записываются как есть, поэтому при любом изменении их элементов меняется версия
+constexpr char FILE_MAGIC[8] = {'T', 'C', 'R', 'O', 'U', 'T', 'E', 'R'};
+constexpr uint32_t FILE_VERSION = 2;
+constexpr uint32_t FILE_ARRAYS_COUNT = 9;
+constexpr size_t FILE_ALIGNMENT = 8;
+
+struct FileHeader {
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t arrays_count = 0;
+    // TransportRouter::ComputeChecksum справочника и настроек
+    uint64_t checksum = 0;
+    // Контрольная сумма содержимого массивов
+    uint64_t payload_checksum = 0;
+    // Число элементов каждого массива
+    uint64_t sizes[FILE_ARRAYS_COUNT] = {};
+};
+
+size_t AlignUp(size_t size) {
+    return (size + FILE_ALIGNMENT - 1) / FILE_ALIGNMENT * FILE_ALIGNMENT;
+}
+
+// Начала списков рёбер vertex_count вершин: с нуля, не убывают и заканчиваются числом рёбер
+bool IsValidBegin(std::span<const uint32_t> begin, size_t vertex_count, size_t edges_count) {
+    return begin.size() == vertex_count + 1 && begin.front() == 0 && begin.back() == edges_count
+           && std::is_sorted(begin.begin(), begin.end());
+}
+
+}  // namespace
+
+TransportRouter::Workspace::Workspace(const TransportRouter& router)
+    : forward_(router.GetVertexCount()),
+      backward_(router.GetVertexCount()) {
+    path_edges_.reserve(router.GetVertexCount());
+    route_.reserve(router.GetVertexCount());
+    reachable_.reserve(router.GetVertexCount());
+}
+
+TransportRouter::Workspace::SearchState::SearchState(size_t vertex_count)
+    : times_(vertex_count, UNREACHED),
+      prev_edges_(vertex_count, NO_EDGE),
+      heap_positions_(vertex_count, NOT_IN_HEAP) {
+    heap_.reserve(vertex_count);
+    touched_.reserve(vertex_count);
+}
+
+void TransportRouter::Workspace::SearchState::Reset() {
+    for (StopId stop : touched_) {
+        times_[stop] = UNREACHED;
+        prev_edges_[stop] = NO_EDGE;
+        heap_positions_[stop] = NOT_IN_HEAP;
+    }
+    touched_.clear();
+    heap_.clear();
+}
+
+void TransportRouter::Workspace::SearchState::Relax(StopId stop, double time, uint32_t edge) {
+    if (!(time < times_[stop])) {
+        return;
+    }
+
+    if (times_[stop] == UNREACHED) {
+        touched_.push_back(stop);
+    }
+    times_[stop] = time;
+    prev_edges_[stop] = edge;
+
+    if (heap_positions_[stop] == NOT_IN_HEAP) {
+        heap_positions_[stop] = static_cast<uint32_t>(heap_.size());
+        heap_.push_back(stop);
+    }
+    SiftUp(heap_positions_[stop]);
+}
+
+StopId TransportRouter::Workspace::SearchState::PopMin() {
+    const StopId top = heap_.front();
+    heap_positions_[top] = NOT_IN_HEAP;
+
+    const StopId last = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty()) {
+        heap_[0] = last;
+        heap_positions_[last] = 0;
+        SiftDown(0);
+    }
+
+    return top;
+}
+
+void TransportRouter::Workspace::SearchState::SiftUp(uint32_t position) {
+    const StopId stop = heap_[position];
+    const double time = times_[stop];
+
+    while (position > 0) {
+        const uint32_t parent = (position - 1) / 2;
+        if (!(time < times_[heap_[parent]])) {
+            break;
+        }
+        heap_[position] = heap_[parent];
+        heap_positions_[heap_[position]] = position;
+        position = parent;
+    }
+
+    heap_[position] = stop;
+    heap_positions_[stop] = position;
+}
+
+void TransportRouter::Workspace::SearchState::SiftDown(uint32_t position) {
+    const StopId stop = heap_[position];
+    const double time = times_[stop];
+    const uint32_t size = static_cast<uint32_t>(heap_.size());
+
+    while (true) {
+        uint32_t child = position * 2 + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && times_[heap_[child + 1]] < times_[heap_[child]]) {
+            ++child;
+        }
+        if (!(times_[heap_[child]] < time)) {
+            break;
+        }
+        heap_[position] = heap_[child];
+        heap_positions_[heap_[position]] = position;
+        position = child;
+    }
+
+    heap_[position] = stop;
+    heap_positions_[stop] = position;
+}
+
+TransportRouter::TransportRouter(const TransportCatalogue& catalogue, RoutingSettings settings)
+    : settings_(settings),
+      checksum_(ComputeChecksum(catalogue, settings)) {
+    const size_t stops_count = catalogue.GetStopsCount();
+    const double meters_per_minute = settings_.bus_velocity * 1000 / 60;
+
+    // Перебирает все поездки: на каждом маршруте от любой остановки до любой следующей.
+    // Некольцевой маршрут проходится до конечной и обратно, на конечной пассажиры выходят,
+    // поэтому поездки строятся отдельно для пути туда и пути обратно
+    std::vector<int64_t> offsets;
+    auto for_each_ride = [&](auto&& callback) {
+        for (BusId id = 0; id < catalogue.GetBusesCount(); ++id) {
+            const Bus bus = catalogue.GetBus(id);
+            if (bus.stops.empty()) {
+                continue;
+            }
+
+            // Расстояние от начала маршрута до каждой его остановки
+            offsets.assign(1, 0);
+            for (size_t i = 1; i < bus.stops.size(); ++i) {
+                offsets.push_back(offsets.back() + catalogue.GetDistance(bus.stops[i - 1], bus.stops[i]));
+            }
+
+            auto add_rides = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    for (size_t j = i + 1; j < end; ++j) {
+                        if (bus.stops[i] == bus.stops[j]) {
+                            continue;
+                        }
+                        callback(Ride{id, bus.stops[i], bus.stops[j], static_cast<uint32_t>(j - i),
+                                      static_cast<double>(offsets[j] - offsets[i]) / meters_per_minute});
+                    }
+                }
+            };
+
+            if (bus.is_roundtrip) {
+                add_rides(0, bus.stops.size());
+            } else {
+                const size_t terminal = bus.stops.size() / 2;
+                add_rides(0, terminal + 1);
+                add_rides(terminal, bus.stops.size());
+            }
+        }
+    };
+
+    // Первый проход считает поездки из каждой остановки, второй раскладывает их
+    // по начальным остановкам в порядке перебора
+    edges_begin_.assign(stops_count + 1, 0);
+    for_each_ride([this](const Ride& ride) {
+        ++edges_begin_[ride.from + 1];
+    });
+    std::partial_sum(edges_begin_.begin(), edges_begin_.end(), edges_begin_.begin());
+
+    rides_.resize(edges_begin_.back());
+    std::vector<uint32_t> fill(edges_begin_.begin(), edges_begin_.end() - 1);
+    for_each_ride([this, &fill](const Ride& ride) {
+        rides_[fill[ride.from]++] = ride;
+    });
+    fill = {};
+
+    // Из поездок в одну остановку остаётся самая быстрая, при равенстве — найденная раньше
+    uint32_t edges_count = 0;
+    for (size_t stop = 0; stop < stops_count; ++stop) {
+        const auto begin = rides_.begin() + edges_begin_[stop];
+        const auto end = rides_.begin() + edges_begin_[stop + 1];
+        edges_begin_[stop] = edges_count;
+
+        std::stable_sort(begin, end, [](const Ride& lhs, const Ride& rhs) {
+            return lhs.to < rhs.to || (lhs.to == rhs.to && lhs.time < rhs.time);
+        });
+        for (auto it = begin; it != end; ++it) {
+            if (it != begin && it->to == (it - 1)->to) {
+                continue;
+            }
+            rides_[edges_count++] = *it;
+        }
+    }
+    edges_begin_[stops_count] = edges_count;
+
+    rides_.resize(edges_count);
+    rides_.shrink_to_fit();
+
+    edges_.reserve(rides_.size());
+    for (const Ride& ride : rides_) {
+        edges_.push_back({.to = ride.to, .weight = settings_.bus_wait_time + ride.time});
+    }
+}
+
+std::optional<TransportRouter> TransportRouter::Load(const std::string& path, const TransportCatalogue& catalogue,
+                                                    RoutingSettings settings) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return std::nullopt;
+    }
+
+    std::optional<io::MappedFile> file;
+    try {
+        file.emplace(path);
+    } catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+    const std::string_view data = file->GetData();
+    FileHeader header;
+    if (data.size() < sizeof(header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION
+        || header.arrays_count != FILE_ARRAYS_COUNT || header.checksum != ComputeChecksum(catalogue, settings)) {
+        return std::nullopt;
+    }
+
+    TransportRouter router;
+    router.settings_ = settings;
+    router.checksum_ = header.checksum;
+
+    size_t offset = sizeof(header);
+    size_t index = 0;
+    bool is_complete = true;
+    Checksum payload;
+    ForEachArray(router, [&](auto& array) {
+        using Element = typename std::decay_t<decltype(array)>::value_type;
+        const uint64_t count = header.sizes[index++];
+        if (!is_complete || offset > data.size() || count > (data.size() - offset) / sizeof(Element)) {
+            is_complete = false;
+            return;
+        }
+
+        array.resize(count);
+        std::memcpy(array.data(), data.data() + offset, count * sizeof(Element));
+        payload.AddBytes(data.data() + offset, count * sizeof(Element));
+        offset += AlignUp(count * sizeof(Element));
+    });
+
+    // Контрольная сумма защищает от случайной порчи, проверка содержимого — от файла,
+    // записанного с ошибкой: номера из массивов дальше используются как индексы без проверок
+    if (!is_complete || offset != data.size() || payload.Get() != header.payload_checksum
+        || !router.IsConsistent(catalogue.GetStopsCount(), catalogue.GetBusesCount())) {
+        return std::nullopt;
+    }
+
+    return router;
+}
+
+bool TransportRouter::IsConsistent(size_t stops_count, size_t buses_count) const {
+    if (!IsValidBegin(edges_begin_, stops_count, edges_.size()) || rides_.size() != edges_.size()) {
+        return false;
+    }
+    for (StopId stop = 0; stop < stops_count; ++stop) {
+        for (uint32_t edge = edges_begin_[stop]; edge < edges_begin_[stop + 1]; ++edge) {
+            const Ride& ride = rides_[edge];
+            if (ride.from != stop || ride.to >= stops_count || edges_[edge].to != ride.to || ride.bus >= buses_count) {
+                return false;
+            }
+        }
+    }
+
+    if (rank_.empty()) {
+        return shortcuts_.empty() && up_begin_.empty() && up_edges_.empty() && down_begin_.empty()
+               && down_edges_.empty();
+    }
+    if (rank_.size() != stops_count || !IsValidBegin(up_begin_, stops_count, up_edges_.size())
+        || !IsValidBegin(down_begin_, stops_count, down_edges_.size())) {
+        return false;
+    }
+    // Сокращение состоит из рёбер и сокращений, созданных раньше него, иначе Unpack не остановится
+    const size_t arcs_count = rides_.size() + shortcuts_.size();
+    for (size_t index = 0; index < shortcuts_.size(); ++index) {
+        const Shortcut& shortcut = shortcuts_[index];
+        if (shortcut.from >= stops_count || shortcut.to >= stops_count || shortcut.first >= rides_.size() + index
+            || shortcut.second >= rides_.size() + index) {
+            return false;
+        }
+    }
+    auto is_valid_edge = [&](const HierarchyEdge& edge) {
+        return edge.to < stops_count && edge.id < arcs_count;
+    };
+    return std::all_of(up_edges_.begin(), up_edges_.end(), is_valid_edge)
+           && std::all_of(down_edges_.begin(), down_edges_.end(), is_valid_edge);
+}
+
+void TransportRouter::Save(const std::string& path) const {
+    using namespace std::literals;
+
+    FileHeader header;
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.arrays_count = FILE_ARRAYS_COUNT;
+    header.checksum = checksum_;
+
+    // Массивы пишутся побайтно, поэтому в их элементах не должно быть выравнивающих промежутков,
+    // иначе в файл попадёт неинициализированная память и одинаковые графы дадут разные файлы
+    static_assert(sizeof(Edge) == sizeof(StopId) + sizeof(uint32_t) + sizeof(double));
+    static_assert(sizeof(Ride) == sizeof(BusId) + 2 * sizeof(StopId) + sizeof(uint32_t) + sizeof(double));
+    static_assert(sizeof(HierarchyEdge) == sizeof(StopId) + sizeof(uint32_t) + sizeof(double));
+    static_assert(std::has_unique_object_representations_v<Shortcut>);
+    static_assert(std::has_unique_object_representations_v<uint32_t>);
+
+    size_t index = 0;
+    Checksum payload;
+    ForEachArray(*this, [&](const auto& array) {
+        static_assert(std::is_trivially_copyable_v<typename std::decay_t<decltype(array)>::value_type>);
+        header.sizes[index++] = array.size();
+        payload.AddBytes(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(array[0]));
+    });
+    header.payload_checksum = payload.Get();
+
+    // Файл пишется рядом и подменяет старый одним переименованием
+    const std::string temp_path = path + ".tmp"s;
+    std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ForEachArray(*this, [&output](const auto& array) {
+        const size_t size = array.size() * sizeof(array[0]);
+        const char padding[FILE_ALIGNMENT] = {};
+        output.write(reinterpret_cast<const char*>(array.data()), static_cast<std::streamsize>(size));
+        output.write(padding, static_cast<std::streamsize>(AlignUp(size) - size));
+    });
+    output.close();
+    if (!output) {
+        throw std::runtime_error("Can't write "s + temp_path);
+    }
+
+    std::filesystem::rename(temp_path, path);
+}
+
+uint64_t TransportRouter::ComputeChecksum(const TransportCatalogue& catalogue, RoutingSettings settings) {
+    Checksum checksum;
+    checksum.Add(std::bit_cast<uint64_t>(settings.bus_wait_time));
+    checksum.Add(std::bit_cast<uint64_t>(settings.bus_velocity));
+    checksum.Add(catalogue.GetStopsCount());
+    checksum.Add(catalogue.GetBusesCount());
+
+    for (BusId id = 0; id < catalogue.GetBusesCount(); ++id) {
+        const Bus bus = catalogue.GetBus(id);
+        checksum.Add(bus.stops.size());
+        checksum.Add(bus.is_roundtrip);
+        for (size_t i = 0; i < bus.stops.size(); ++i) {
+            checksum.Add(bus.stops[i]);
+            if (i > 0) {
+                checksum.Add(static_cast<uint64_t>(catalogue.GetDistance(bus.stops[i - 1], bus.stops[i])));
+            }
+        }
+    }
+
+    return checksum.Get();
+}
+
+void TransportRouter::Contract() {
+    if (IsContracted()) {
+        return;
+    }
+
+    const size_t vertex_count = GetVertexCount();
+    const uint32_t rides_count = static_cast<uint32_t>(rides_.size());
+
+    // Граф из ещё не исключённых вершин, рёбра хранятся у обоих концов
+    struct Arc {
+        StopId vertex = 0;
+        uint32_t id = 0;
+        double weight = 0;
+    };
+    std::vector<std::vector<Arc>> out_arcs(vertex_count);
+    std::vector<std::vector<Arc>> in_arcs(vertex_count);
+    for (StopId stop = 0; stop < vertex_count; ++stop) {
+        for (uint32_t edge = edges_begin_[stop]; edge < edges_begin_[stop + 1]; ++edge) {
+            out_arcs[stop].push_back({edges_[edge].to, edge, edges_[edge].weight});
+            in_arcs[edges_[edge].to].push_back({stop, edge, edges_[edge].weight});
+        }
+    }
+
+    struct Candidate {
+        Shortcut shortcut;
+        double weight = 0;
+    };
+    std::vector<Candidate> candidates;
+    std::vector<double> shortcut_weights;
+    Workspace::SearchState witness(vertex_count);
+    std::vector<uint32_t> target_marks(vertex_count, 0);
+    uint32_t search_number = 0;
+
+    // Сокращения, без которых нельзя исключить vertex: путь u → vertex → x нужен, если поиск
+    // из u в обход vertex не нашёл пути не длиннее. Поиск ограничен, поэтому иногда добавляется
+    // лишнее сокращение, но нужное не теряется никогда
+    auto find_shortcuts = [&](StopId vertex, size_t settled_limit) {
+        candidates.clear();
+        for (const Arc& in_arc : in_arcs[vertex]) {
+            double max_weight = 0;
+            for (const Arc& out_arc : out_arcs[vertex]) {
+                if (out_arc.vertex != in_arc.vertex) {
+                    max_weight = std::max(max_weight, in_arc.weight + out_arc.weight);
+                }
+            }
+
+            // Поиск заканчивается, как только достигнуты все концы исходящих рёбер vertex
+            ++search_number;
+            size_t targets_left = 0;
+            for (const Arc& out_arc : out_arcs[vertex]) {
+                if (out_arc.vertex != in_arc.vertex) {
+                    target_marks[out_arc.vertex] = search_number;
+                    ++targets_left;
+                }
+            }
+
+            witness.Reset();
+            witness.Relax(in_arc.vertex, 0, NO_EDGE);
+            for (size_t settled = 0; settled < settled_limit && targets_left > 0 && !witness.IsEmpty(); ++settled) {
+                if (witness.GetMinTime() > max_weight) {
+                    break;
+                }
+                const StopId stop = witness.PopMin();
+                if (target_marks[stop] == search_number) {
+                    --targets_left;
+                }
+                for (const Arc& arc : out_arcs[stop]) {
+                    if (arc.vertex != vertex) {
+                        witness.Relax(arc.vertex, witness.times_[stop] + arc.weight, arc.id);
+                    }
+                }
+            }
+
+            for (const Arc& out_arc : out_arcs[vertex]) {
+                const double weight = in_arc.weight + out_arc.weight;
+                if (out_arc.vertex == in_arc.vertex || witness.times_[out_arc.vertex] <= weight) {
+                    continue;
+                }
+                candidates.push_back({{in_arc.vertex, out_arc.vertex, in_arc.id, out_arc.id}, weight});
+            }
+        }
+    };
+
+    std::vector<uint32_t> contracted_neighbors(vertex_count, 0);
+    // Вершины с меньшим приоритетом исключаются раньше: чем меньше сокращений добавляется
+    // на место удаляемых рёбер и чем меньше исключено соседей, тем вершина менее важна
+    auto get_priority = [&](StopId vertex) {
+        find_shortcuts(vertex, PRIORITY_WITNESS_SETTLED_LIMIT);
+        return static_cast<int64_t>(candidates.size())
+               - static_cast<int64_t>(in_arcs[vertex].size() + out_arcs[vertex].size())
+               + contracted_neighbors[vertex];
+    };
+
+    using QueueItem = std::pair<int64_t, StopId>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> queue;
+    for (StopId stop = 0; stop < vertex_count; ++stop) {
+        queue.push({get_priority(stop), stop});
+    }
+
+    std::vector<uint32_t> rank(vertex_count, 0);
+    for (uint32_t next_rank = 0; !queue.empty(); ) {
+        const StopId vertex = queue.top().second;
+        queue.pop();
+
+        // Приоритеты соседей меняются по мере сжатия и пересчитываются, только когда
+        // вершина оказывается первой в очереди
+        const int64_t priority = get_priority(vertex);
+        if (!queue.empty() && priority > queue.top().first) {
+            queue.push({priority, vertex});
+            continue;
+        }
+
+        find_shortcuts(vertex, WITNESS_SETTLED_LIMIT);
+        for (const Candidate& candidate : candidates) {
+            const Shortcut& shortcut = candidate.shortcut;
+            std::vector<Arc>& from_arcs = out_arcs[shortcut.from];
+            auto it = std::find_if(from_arcs.begin(), from_arcs.end(), [&shortcut](const Arc& arc) {
+                return arc.vertex == shortcut.to;
+            });
+            if (it != from_arcs.end() && it->weight <= candidate.weight) {
+                continue;
+            }
+
+            const uint32_t id = rides_count + static_cast<uint32_t>(shortcuts_.size());
+            shortcuts_.push_back(shortcut);
+            shortcut_weights.push_back(candidate.weight);
+
+            std::vector<Arc>& to_arcs = in_arcs[shortcut.to];
+            if (it != from_arcs.end()) {
+                *it = {shortcut.to, id, candidate.weight};
+                *std::find_if(to_arcs.begin(), to_arcs.end(), [&shortcut](const Arc& arc) {
+                    return arc.vertex == shortcut.from;
+                }) = {shortcut.from, id, candidate.weight};
+            } else {
+                from_arcs.push_back({shortcut.to, id, candidate.weight});
+                to_arcs.push_back({shortcut.from, id, candidate.weight});
+            }
+        }
+
+        rank[vertex] = next_rank++;
+        auto is_vertex = [vertex](const Arc& arc) {
+            return arc.vertex == vertex;
+        };
+        for (const Arc& arc : in_arcs[vertex]) {
+            std::erase_if(out_arcs[arc.vertex], is_vertex);
+            ++contracted_neighbors[arc.vertex];
+        }
+        for (const Arc& arc : out_arcs[vertex]) {
+            std::erase_if(in_arcs[arc.vertex], is_vertex);
+            ++contracted_neighbors[arc.vertex];
+        }
+        in_arcs[vertex] = {};
+        out_arcs[vertex] = {};
+    }
+
+    // Каждое ребро и сокращение попадает в восходящий граф своего начала
+    // или в нисходящий граф своего конца
+    auto for_each_arc = [&](auto&& callback) {
+        for (uint32_t id = 0; id < rides_count; ++id) {
+            callback(rides_[id].from, rides_[id].to, id, edges_[id].weight);
+        }
+        for (uint32_t index = 0; index < shortcuts_.size(); ++index) {
+            callback(shortcuts_[index].from, shortcuts_[index].to, rides_count + index, shortcut_weights[index]);
+        }
+    };
+
+    up_begin_.assign(vertex_count + 1, 0);
+    down_begin_.assign(vertex_count + 1, 0);
+    for_each_arc([&](StopId from, StopId to, uint32_t, double) {
+        if (rank[from] < rank[to]) {
+            ++up_begin_[from + 1];
+        } else {
+            ++down_begin_[to + 1];
+        }
+    });
+    std::partial_sum(up_begin_.begin(), up_begin_.end(), up_begin_.begin());
+    std::partial_sum(down_begin_.begin(), down_begin_.end(), down_begin_.begin());
+
+    up_edges_.resize(up_begin_.back());
+    down_edges_.resize(down_begin_.back());
+    std::vector<uint32_t> up_fill(up_begin_.begin(), up_begin_.end() - 1);
+    std::vector<uint32_t> down_fill(down_begin_.begin(), down_begin_.end() - 1);
+    for_each_arc([&](StopId from, StopId to, uint32_t id, double weight) {
+        if (rank[from] < rank[to]) {
+            up_edges_[up_fill[from]++] = {to, id, weight};
+        } else {
+            down_edges_[down_fill[to]++] = {from, id, weight};
+        }
+    });
+
+    shortcuts_.shrink_to_fit();
+    rank_ = std::move(rank);
+}
+
+std::optional<TransportRouter::Route> TransportRouter::FindRoute(StopId from, StopId to, Workspace& workspace) const {
+    const bool found = IsContracted() ? SearchHierarchy(from, to, workspace) : Search(from, to, workspace);
+    if (!found) {
+        return std::nullopt;
+    }
+
+    workspace.route_.clear();
+    for (uint32_t id : workspace.path_edges_) {
+        Unpack(id, workspace.route_);
+    }
+
+    // Время складывается по рёбрам от начала пути, как при обычном поиске,
+    // поэтому для одного и того же пути оно совпадает до последнего бита
+    double total_time = 0;
+    for (const Ride& ride : workspace.route_) {
+        total_time += settings_.bus_wait_time + ride.time;
+    }
+
+    return Route{total_time, workspace.route_};
+}
+
+bool TransportRouter::Search(StopId from, StopId to, Workspace& workspace) const {
+    Workspace::SearchState& search = workspace.forward_;
+    search.Reset();
+    search.Relax(from, 0, NO_EDGE);
+
+    while (!search.IsEmpty()) {
+        const StopId stop = search.PopMin();
+        if (stop == to) {
+            break;
+        }
+
+        const double time = search.times_[stop];
+        for (uint32_t edge = edges_begin_[stop]; edge < edges_begin_[stop + 1]; ++edge) {
+            search.Relax(edges_[edge].to, time + edges_[edge].weight, edge);
+        }
+    }
+
+    if (search.times_[to] == UNREACHED) {
+        return false;
+    }
+
+    workspace.path_edges_.clear();
+    for (StopId stop = to; stop != from; stop = rides_[search.prev_edges_[stop]].from) {
+        workspace.path_edges_.push_back(search.prev_edges_[stop]);
+    }
+    std::reverse(workspace.path_edges_.begin(), workspace.path_edges_.end());
+
+    return true;
+}
+
+bool TransportRouter::SearchHierarchy(StopId from, StopId to, Workspace& workspace) const {
+    Workspace::SearchState& forward = workspace.forward_;
+    Workspace::SearchState& backward = workspace.backward_;
+    forward.Reset();
+    backward.Reset();
+    forward.Relax(from, 0, NO_EDGE);
+    backward.Relax(to, 0, NO_EDGE);
+
+    // Лучший путь проходит через самую важную свою вершину meeting: до неё он только
+    // поднимается от from, после неё только спускается к to
+    double best_time = UNREACHED;
+    std::optional<StopId> meeting;
+    while (true) {
+        const bool forward_active = !forward.IsEmpty() && forward.GetMinTime() < best_time;
+        const bool backward_active = !backward.IsEmpty() && backward.GetMinTime() < best_time;
+        if (!forward_active && !backward_active) {
+            break;
+        }
+
+        const bool is_forward = forward_active && (!backward_active || forward.GetMinTime() <= backward.GetMinTime());
+        Workspace::SearchState& search = is_forward ? forward : backward;
+        const Workspace::SearchState& other = is_forward ? backward : forward;
+        const std::vector<uint32_t>& begin = is_forward ? up_begin_ : down_begin_;
+        const std::vector<HierarchyEdge>& edges = is_forward ? up_edges_ : down_edges_;
+
+        const StopId stop = search.PopMin();
+        const double time = search.times_[stop];
+        if (time + other.times_[stop] < best_time) {
+            best_time = time + other.times_[stop];
+            meeting = stop;
+        }
+
+        for (uint32_t edge = begin[stop]; edge < begin[stop + 1]; ++edge) {
+            search.Relax(edges[edge].to, time + edges[edge].weight, edges[edge].id);
+        }
+    }
+
+    if (!meeting) {
+        return false;
+    }
+
+    auto get_from = [this](uint32_t id) {
+        return id < rides_.size() ? rides_[id].from : shortcuts_[id - rides_.size()].from;
+    };
+    auto get_to = [this](uint32_t id) {
+        return id < rides_.size() ? rides_[id].to : shortcuts_[id - rides_.size()].to;
+    };
+
+    workspace.path_edges_.clear();
+    for (StopId stop = *meeting; stop != from; stop = get_from(forward.prev_edges_[stop])) {
+        workspace.path_edges_.push_back(forward.prev_edges_[stop]);
+    }
+    std::reverse(workspace.path_edges_.begin(), workspace.path_edges_.end());
+    for (StopId stop = *meeting; stop != to; stop = get_to(backward.prev_edges_[stop])) {
+        workspace.path_edges_.push_back(backward.prev_edges_[stop]);
+    }
+
+    return true;
+}
+
+std::span<const TransportRouter::ReachableStop> TransportRouter::FindReachable(StopId from, CostType cost_type,
+                                                                              double max_cost,
+                                                                              Workspace& workspace) const {
+    // Расстояния в справочнике целые, поэтому по времени поездки расстояние восстанавливается точно
+    const double meters_per_minute = settings_.bus_velocity * 1000 / 60;
+    auto get_cost = [&](uint32_t edge) {
+        return cost_type == CostType::TIME ? edges_[edge].weight : std::round(rides_[edge].time * meters_per_minute);
+    };
+
+    Workspace::SearchState& search = workspace.forward_;
+    search.Reset();
+    workspace.reachable_.clear();
+    if (!(0 <= max_cost)) {
+        return {};
+    }
+    search.Relax(from, 0, NO_EDGE);
+
+    // В кучу попадают только вершины с ценой не больше max_cost, так что все извлечённые достижимы
+    while (!search.IsEmpty()) {
+        const StopId stop = search.PopMin();
+        const double cost = search.times_[stop];
+        workspace.reachable_.push_back({stop, cost});
+
+        for (uint32_t edge = edges_begin_[stop]; edge < edges_begin_[stop + 1]; ++edge) {
+            const double next_cost = cost + get_cost(edge);
+            if (next_cost <= max_cost) {
+                search.Relax(edges_[edge].to, next_cost, edge);
+            }
+        }
+    }
+
+    return workspace.reachable_;
+}
+
+std::vector<double> TransportRouter::ComputeMatrix(std::span<const StopId> from, std::span<const StopId> to,
+                                                   unsigned threads) const {
+    std::vector<double> matrix(from.size() * to.size(), UNREACHED);
+    if (matrix.empty()) {
+        return matrix;
+    }
+
+    if (threads == 0) {
+        threads = GetDefaultThreadCount();
+    }
+    if (IsContracted()) {
+        ComputeRowsHierarchy(from, to, matrix, threads);
+    } else {
+        ComputeRows(from, to, matrix, threads);
+    }
+
+    return matrix;
+}
+
+void TransportRouter::ComputeRows(std::span<const StopId> from, std::span<const StopId> to,
+                                  std::span<double> matrix, unsigned threads) const {
+    std::vector<bool> is_target(GetVertexCount(), false);
+    size_t targets_count = 0;
+    for (StopId stop : to) {
+        if (!is_target[stop]) {
+            is_target[stop] = true;
+            ++targets_count;
+        }
+    }
+
+    const unsigned parts = static_cast<unsigned>(std::min<size_t>(threads, from.size()));
+    RunParallel(parts, [&](unsigned part) {
+        Workspace::SearchState search(GetVertexCount());
+        const auto [sources_begin, sources_end] = PartRange(from.size(), parts, part);
+
+        for (size_t source = sources_begin; source < sources_end; ++source) {
+            search.Reset();
+            search.Relax(from[source], 0, NO_EDGE);
+
+            for (size_t targets_left = targets_count; targets_left > 0 && !search.IsEmpty(); ) {
+                const StopId stop = search.PopMin();
+                if (is_target[stop]) {
+                    --targets_left;
+                }
+
+                const double time = search.times_[stop];
+                for (uint32_t edge = edges_begin_[stop]; edge < edges_begin_[stop + 1]; ++edge) {
+                    search.Relax(edges_[edge].to, time + edges_[edge].weight, edge);
+                }
+            }
+
+            // Все to уже извлечены из кучи, так что их время окончательное
+            std::span<double> row = matrix.subspan(source * to.size(), to.size());
+            for (size_t target = 0; target < to.size(); ++target) {
+                row[target] = search.times_[to[target]];
+            }
+        }
+    });
+}
+
+void TransportRouter::ComputeRowsHierarchy(std::span<const StopId> from, std::span<const StopId> to,
+                                           std::span<double> matrix, unsigned threads) const {
+    const size_t vertex_count = GetVertexCount();
+
+    // Поиски по нисходящим рёбрам от каждой to: запись (vertex, entry) значит,
+    // что из vertex до to[entry.target] можно спуститься за entry.time
+    const unsigned target_parts = static_cast<unsigned>(std::min<size_t>(threads, to.size()));
+    std::vector<std::vector<std::pair<StopId, BucketEntry>>> part_entries(target_parts);
+    RunParallel(target_parts, [&](unsigned part) {
+        Workspace::SearchState search(vertex_count);
+        const auto [targets_begin, targets_end] = PartRange(to.size(), target_parts, part);
+
+        for (size_t target = targets_begin; target < targets_end; ++target) {
+            search.Reset();
+            search.Relax(to[target], 0, NO_EDGE);
+
+            while (!search.IsEmpty()) {
+                const StopId stop = search.PopMin();
+                const double time = search.times_[stop];
+                part_entries[part].push_back({stop, {static_cast<uint32_t>(target), time}});
+
+                for (uint32_t edge = down_begin_[stop]; edge < down_begin_[stop + 1]; ++edge) {
+                    search.Relax(down_edges_[edge].to, time + down_edges_[edge].weight, edge);
+                }
+            }
+        }
+    });
+
+    // Корзина вершины v — [buckets_begin[v], buckets_begin[v + 1])
+    std::vector<uint32_t> buckets_begin(vertex_count + 1, 0);
+    for (const auto& entries : part_entries) {
+        for (const auto& [stop, entry] : entries) {
+            ++buckets_begin[stop + 1];
+        }
+    }
+    std::partial_sum(buckets_begin.begin(), buckets_begin.end(), buckets_begin.begin());
+
+    std::vector<BucketEntry> buckets(buckets_begin.back());
+    std::vector<uint32_t> fill(buckets_begin.begin(), buckets_begin.end() - 1);
+    for (auto& entries : part_entries) {
+        for (const auto& [stop, entry] : entries) {
+            buckets[fill[stop]++] = entry;
+        }
+        entries = {};
+    }
+
+    // Кратчайший путь поднимается от from и спускается к to, поэтому его время —
+    // наименьшая сумма времени до вершины и записи из её корзины
+    const unsigned source_parts = static_cast<unsigned>(std::min<size_t>(threads, from.size()));
+    RunParallel(source_parts, [&](unsigned part) {
+        Workspace::SearchState search(vertex_count);
+        const auto [sources_begin, sources_end] = PartRange(from.size(), source_parts, part);
+
+        for (size_t source = sources_begin; source < sources_end; ++source) {
+            std::span<double> row = matrix.subspan(source * to.size(), to.size());
+            search.Reset();
+            search.Relax(from[source], 0, NO_EDGE);
+
+            while (!search.IsEmpty()) {
+                const StopId stop = search.PopMin();
+                const double time = search.times_[stop];
+                for (uint32_t index = buckets_begin[stop]; index < buckets_begin[stop + 1]; ++index) {
+                    double& cell = row[buckets[index].target];
+                    cell = std::min(cell, time + buckets[index].time);
+                }
+
+                for (uint32_t edge = up_begin_[stop]; edge < up_begin_[stop + 1]; ++edge) {
+                    search.Relax(up_edges_[edge].to, time + up_edges_[edge].weight, edge);
+                }
+            }
+        }
+    });
+}
+
+void TransportRouter::Unpack(uint32_t id, std::vector<Ride>& route) const {
+    if (id < rides_.size()) {
+        route.push_back(rides_[id]);
+        return;
+    }
+
+    const Shortcut& shortcut = shortcuts_[id - rides_.size()];
+    Unpack(shortcut.first, route);
+    Unpack(shortcut.second, route);
+}
+
+}
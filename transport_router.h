@@ -0,0 +1,266 @@
+#pragma once
+
+#include "transport_catalogue.h"
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace transport_catalogue {
+
+struct RoutingSettings {
+    // Ожидание автобуса на остановке, минуты
+    double bus_wait_time = 0;
+    // Скорость автобуса, км/ч
+    double bus_velocity = 0;
+};
+
+/*
+ * Поиск самого быстрого пути между остановками. Граф строится один раз по маршрутам
+ * и дорожным расстояниям справочника: вершины — остановки, ребро from → to — поездка
+ * на одном автобусе без пересадок, его вес — ожидание автобуса на from и время в пути.
+ * Из нескольких поездок между одной парой остановок остаётся самая быстрая.
+ * Рёбра хранятся в сжатом виде (CSR): исходящие рёбра вершины лежат подряд
+ */
+class TransportRouter {
+public:
+    // Поездка на одном автобусе через span_count перегонов
+    struct Ride {
+        BusId bus = 0;
+        StopId from = 0;
+        StopId to = 0;
+        uint32_t span_count = 0;
+        // Время в пути без ожидания, минуты
+        double time = 0;
+    };
+
+    struct Route {
+        double total_time = 0;
+        // Поездки по порядку. Перед каждой — ожидание bus_wait_time на её начальной остановке
+        std::span<const Ride> rides;
+    };
+
+    // Чем ограничен поиск достижимых остановок
+    enum class CostType {
+        // Время в минутах вместе с ожиданием на каждой посадке
+        TIME,
+        // Расстояние по дорогам в метрах, ожидание не учитывается
+        DISTANCE,
+    };
+
+    struct ReachableStop {
+        StopId stop = 0;
+        double cost = 0;
+    };
+
+    /*
+     * Рабочая память поиска, её размер определяется графом. Поиск не выделяет память
+     * и восстанавливает только то, что изменил, поэтому один Workspace служит любому
+     * числу запросов. Одновременные поиски должны пользоваться разными Workspace
+     */
+    class Workspace {
+    public:
+        explicit Workspace(const TransportRouter& router);
+
+    private:
+        friend class TransportRouter;
+
+        // Состояние поиска Дейкстры в одном направлении
+        class SearchState {
+        public:
+            explicit SearchState(size_t vertex_count);
+
+            // Возвращает в исходное состояние вершины, затронутые прошлым поиском
+            void Reset();
+            // Если time меньше известного времени до stop, запоминает его и ребро edge,
+            // по которому пришли, и ставит stop в кучу или поднимает в ней
+            void Relax(StopId stop, double time, uint32_t edge);
+            StopId PopMin();
+
+            bool IsEmpty() const {
+                return heap_.empty();
+            }
+
+            // Наименьшее время среди вершин в куче, куча не пуста
+            double GetMinTime() const {
+                return times_[heap_.front()];
+            }
+
+            // Время до вершины, для недостигнутых — бесконечность
+            std::vector<double> times_;
+            // Ребро, по которому пришли в вершину
+            std::vector<uint32_t> prev_edges_;
+
+        private:
+            void SiftUp(uint32_t position);
+            void SiftDown(uint32_t position);
+
+            // Двоичная куча вершин по времени и позиция каждой вершины в ней
+            std::vector<StopId> heap_;
+            std::vector<uint32_t> heap_positions_;
+            // Вершины, которые нужно вернуть в исходное состояние перед следующим поиском
+            std::vector<StopId> touched_;
+        };
+
+        SearchState forward_;
+        // Поиск от конечной остановки по иерархии
+        SearchState backward_;
+        // Рёбра найденного пути от начала к концу, для иерархии — вместе с сокращениями
+        std::vector<uint32_t> path_edges_;
+        std::vector<Ride> route_;
+        std::vector<ReachableStop> reachable_;
+    };
+
+    // Выбрасывает std::out_of_range, если между соседними остановками маршрута не задано расстояние
+    TransportRouter(const TransportCatalogue& catalogue, RoutingSettings settings);
+
+    /*
+     * Загружает граф, сохранённый Save. Файл отображается в память, и массивы копируются
+     * из него целиком, без построения. Возвращает nullopt, если файла нет, его формат
+     * другой версии, он повреждён, массивы в нём не согласованы между собой
+     * или он построен для другого справочника или настроек
+     */
+    static std::optional<TransportRouter> Load(const std::string& path, const TransportCatalogue& catalogue,
+                                               RoutingSettings settings);
+
+    // Сохраняет граф и иерархию, если она построена, для Load. Файл заменяется целиком,
+    // так что читатели не увидят его недописанным. Выбрасывает std::runtime_error при ошибке записи
+    void Save(const std::string& path) const;
+
+    // Контрольная сумма всего, от чего зависит граф: маршрутов, расстояний между
+    // соседними остановками на них и настроек
+    static uint64_t ComputeChecksum(const TransportCatalogue& catalogue, RoutingSettings settings);
+
+    const RoutingSettings& GetSettings() const {
+        return settings_;
+    }
+
+    size_t GetVertexCount() const {
+        return edges_begin_.size() - 1;
+    }
+
+    size_t GetEdgeCount() const {
+        return edges_.size();
+    }
+
+    /*
+     * Строит иерархию сжатия (contraction hierarchy). Вершины по очереди исключаются из графа,
+     * начиная с наименее важных, а кратчайшие пути через исключённую вершину сохраняются
+     * рёбрами-сокращениями. После этого FindRoute ищет от обоих концов только по рёбрам
+     * к более важным вершинам, что просматривает лишь малую часть графа.
+     * Время найденных путей то же, что у обычного поиска
+     */
+    void Contract();
+
+    bool IsContracted() const {
+        return !rank_.empty();
+    }
+
+    // Самый быстрый путь from → to или nullopt, если до to не доехать.
+    // Route::rides действителен до следующего поиска с тем же workspace
+    std::optional<Route> FindRoute(StopId from, StopId to, Workspace& workspace) const;
+
+    /*
+     * Остановки, до которых из from можно добраться с ценой не больше max_cost, вместе с from,
+     * по возрастанию цены. Вершины дороже max_cost в поиск не попадают, поэтому
+     * он просматривает только достижимую часть графа и не выделяет память. Результат действителен до следующего
+     * поиска с тем же workspace
+     */
+    std::span<const ReachableStop> FindReachable(StopId from, CostType cost_type, double max_cost,
+                                                 Workspace& workspace) const;
+
+    /*
+     * Время от каждой остановки from до каждой остановки to по строкам: from[i] → to[j]
+     * в ячейке i * to.size() + j, для недостижимых — бесконечность. Без иерархии из каждой
+     * from выполняется один поиск, который заканчивается, когда достигнуты все to.
+     * С иерархией поиски вверх от каждой to раскладывают время по корзинам вершин,
+     * а поиск вверх от from собирает из корзин сразу всю строку. Время может отличаться
+     * от FindRoute в последнем знаке, так как складывается в другом порядке.
+     * Строки делятся между threads потоками, 0 — по числу ядер
+     */
+    std::vector<double> ComputeMatrix(std::span<const StopId> from, std::span<const StopId> to,
+                                      unsigned threads = 0) const;
+
+private:
+    TransportRouter() = default;
+
+    struct Edge {
+        StopId to = 0;
+        // Заполняет промежуток перед weight, чтобы Save не записывал неинициализированных байт
+        uint32_t reserved = 0;
+        // Ожидание и время в пути, минуты
+        double weight = 0;
+    };
+
+    // Сокращение заменяет путь из двух рёбер first и second. Номер сокращения в рёбрах
+    // иерархии — rides_.size() + его индекс, номера рёбер графа — индексы rides_
+    struct Shortcut {
+        StopId from = 0;
+        StopId to = 0;
+        uint32_t first = 0;
+        uint32_t second = 0;
+    };
+
+    // Ребро иерархии. В восходящем графе ведёт к более важной вершине, в нисходящем
+    // хранится у своего конца и ведёт обратно к более важному началу
+    struct HierarchyEdge {
+        StopId to = 0;
+        uint32_t id = 0;
+        double weight = 0;
+    };
+
+    // Время до to[target] от вершины, в корзине которой лежит запись
+    struct BucketEntry {
+        uint32_t target = 0;
+        double time = 0;
+    };
+
+    void ComputeRows(std::span<const StopId> from, std::span<const StopId> to,
+                     std::span<double> matrix, unsigned threads) const;
+    void ComputeRowsHierarchy(std::span<const StopId> from, std::span<const StopId> to,
+                              std::span<double> matrix, unsigned threads) const;
+
+    // Вызывает visit для каждого массива графа и иерархии в порядке их записи в файл
+    template <typename Router, typename Visitor>
+    static void ForEachArray(Router& router, Visitor&& visit) {
+        visit(router.edges_begin_);
+        visit(router.edges_);
+        visit(router.rides_);
+        visit(router.rank_);
+        visit(router.shortcuts_);
+        visit(router.up_begin_);
+        visit(router.up_edges_);
+        visit(router.down_begin_);
+        visit(router.down_edges_);
+    }
+
+    // Согласованы ли массивы графа и иерархии между собой и с числом остановок и маршрутов
+    bool IsConsistent(size_t stops_count, size_t buses_count) const;
+
+    // Обычный поиск Дейкстры, путь — в workspace.path_edges_
+    bool Search(StopId from, StopId to, Workspace& workspace) const;
+    bool SearchHierarchy(StopId from, StopId to, Workspace& workspace) const;
+    // Дописывает в route_ поездки, из которых состоит ребро или сокращение id
+    void Unpack(uint32_t id, std::vector<Ride>& route) const;
+
+    RoutingSettings settings_;
+    // ComputeChecksum справочника и настроек, по которым построен граф
+    uint64_t checksum_ = 0;
+
+    // Исходящие рёбра вершины v — [edges_begin_[v], edges_begin_[v + 1]).
+    // rides_[e] описывает поездку, которой соответствует ребро edges_[e]
+    std::vector<uint32_t> edges_begin_;
+    std::vector<Edge> edges_;
+    std::vector<Ride> rides_;
+
+    // Иерархия сжатия, пустая до Contract. Чем больше rank_, тем позже исключена вершина
+    std::vector<uint32_t> rank_;
+    std::vector<Shortcut> shortcuts_;
+    std::vector<uint32_t> up_begin_;
+    std::vector<HierarchyEdge> up_edges_;
+    std::vector<uint32_t> down_begin_;
+    std::vector<HierarchyEdge> down_edges_;
+};
+
+}
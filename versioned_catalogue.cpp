@@ -0,0 +1,28 @@
+#include "versioned_catalogue.h"
+
+namespace transport_catalogue {
+
+VersionedCatalogue::VersionedCatalogue()
+    : VersionedCatalogue(std::make_unique<TransportCatalogue>()) {}
+
+VersionedCatalogue::VersionedCatalogue(std::unique_ptr<TransportCatalogue> initial)
+    : current_(std::make_shared<const Version>(Version{0, std::move(initial)})) {}
+
+VersionedCatalogue::Snapshot VersionedCatalogue::GetSnapshot() const {
+    std::shared_ptr<const Version> version = current_.load(std::memory_order_acquire);
+
+    // Снимок держит всю версию, но указывает на справочник внутри неё
+    const TransportCatalogue* catalogue = version->catalogue.get();
+    const uint64_t number = version->number;
+    return {number, std::shared_ptr<const TransportCatalogue>(std::move(version), catalogue)};
+}
+
+uint64_t VersionedCatalogue::Publish(std::unique_ptr<TransportCatalogue> catalogue) {
+    // Писатель один, поэтому читать номер текущей версии можно без синхронизации с другими писателями
+    const uint64_t number = current_.load(std::memory_order_relaxed)->number + 1;
+    current_.store(std::make_shared<const Version>(Version{number, std::move(catalogue)}),
+                   std::memory_order_release);
+    return number;
+}
+
+}
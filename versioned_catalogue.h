@@ -0,0 +1,77 @@
+#pragma once
+
+#include "transport_catalogue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace transport_catalogue {
+
+/*
+ * Справочник, который можно читать во время обновления. Читатель берёт снимок —
+ * неизменяемую версию справочника, которая живёт, пока на неё есть ссылка, и не видит
+ * последующих изменений. Писатель меняет копию текущей версии и публикует её заменой
+ * указателя, так что читатели не ждут, пока он копирует и меняет справочник. Копия делит
+ * с прежней версией все столбцы и копирует только блоки, которые меняет обновление,
+ * поэтому небольшое обновление стоит порядка размера справочника, делённого на тысячу.
+ * Это не lock-free: atomic<shared_ptr> в libstdc++ защищает указатель внутренней
+ * блокировкой, но она держится лишь на время копирования указателя при GetSnapshot
+ * и замены при публикации, независимо от размера справочника.
+ * Через него со справочником работает RequestHandler: каждая пачка запросов читает
+ * один снимок, поэтому запросы можно обслуживать во время обновлений
+ */
+class VersionedCatalogue {
+public:
+    struct Snapshot {
+        // Номер версии, начальная версия — 0
+        uint64_t version = 0;
+        std::shared_ptr<const TransportCatalogue> catalogue;
+
+        const TransportCatalogue& operator*() const {
+            return *catalogue;
+        }
+
+        const TransportCatalogue* operator->() const {
+            return catalogue.get();
+        }
+    };
+
+    VersionedCatalogue();
+    explicit VersionedCatalogue(std::unique_ptr<TransportCatalogue> initial);
+
+    VersionedCatalogue(const VersionedCatalogue&) = delete;
+    VersionedCatalogue& operator=(const VersionedCatalogue&) = delete;
+
+    // Безопасно вызывать из любого числа потоков одновременно с Update
+    Snapshot GetSnapshot() const;
+
+    /*
+     * Вызывает update(TransportCatalogue&) для копии текущей версии и публикует результат
+     * как новую версию, номер которой возвращает. Если update выбросил исключение,
+     * опубликованная версия не меняется. Писатели выполняются по очереди
+     */
+    template <typename UpdateFunc>
+    uint64_t Update(UpdateFunc&& update) {
+        std::lock_guard lock(write_mutex_);
+
+        auto next = std::make_unique<TransportCatalogue>(*GetSnapshot());
+        update(*next);
+        return Publish(std::move(next));
+    }
+
+private:
+    struct Version {
+        uint64_t number = 0;
+        std::unique_ptr<const TransportCatalogue> catalogue;
+    };
+
+    uint64_t Publish(std::unique_ptr<TransportCatalogue> catalogue);
+
+    std::atomic<std::shared_ptr<const Version>> current_;
+    // Только для писателей, GetSnapshot его не захватывает
+    std::mutex write_mutex_;
+};
+
+}